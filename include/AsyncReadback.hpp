@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "glad/gl.h"
+
+/**
+ * Non-blocking readback of rendered frames through a ring of pixel-pack buffers.
+ *
+ * `capture()` queues a `glReadPixels()` of the bound read framebuffer into the next buffer and fences
+ * it; the consumer is called once the GPU is done with that frame, usually while later frames are
+ * being rendered (with 3 buffers, frame N is handed over while frame N+2 is drawn). Buffers are
+ * persistently mapped, so the consumer gets a pointer straight into them : it is only valid during
+ * the call. The OpenGL context must be current for every call, including destruction.
+ */
+class AsyncReadback {
+    public: // Public types
+        /// Receives `size` bytes of RGBA pixels (bottom row first) of the frame captured with `frameId`
+        typedef std::function<void(const uint8_t *rgba, size_t size, uint64_t frameId)> Consumer;
+
+    private: // Private types
+        struct Slot {
+            GLuint         bufferAddress; ///< Pixel-pack buffer
+            const uint8_t *mapping;       ///< Persistent mapping of the buffer
+            GLsync         fence;         ///< Signaled when the readback is done (NULL when free)
+            uint64_t       frameId;       ///< Frame being read back
+        };
+
+    private: // Private fields
+        unsigned int      width;     ///< Captured width, in pixels
+        unsigned int      height;    ///< Captured height, in pixels
+        size_t            frameSize; ///< Bytes per frame
+        Consumer          consumer;  ///< Destination of the frames
+        std::vector<Slot> slots;     ///< Ring of buffers
+        size_t            oldest;    ///< Oldest in-flight slot
+        size_t            inFlight;  ///< Number of queued readbacks
+        uint64_t          stalls;    ///< Captures that had to wait for a previous readback
+
+    public:  // Public functions
+        AsyncReadback(unsigned int width, unsigned int height, const Consumer &consumer, size_t ringSize = 3);
+        ~AsyncReadback();
+
+        AsyncReadback(const AsyncReadback &) = delete;
+        AsyncReadback &operator=(const AsyncReadback &) = delete;
+
+        void   capture(uint64_t frameId);
+        size_t poll();
+        void   flush();
+
+        // Getters
+        uint64_t get_stall_count() const;
+
+    private: // Private functions
+        bool consume_oldest(bool wait);
+        void release_slots(size_t count);
+};
@@ -1,12 +1,19 @@
 #pragma once
 
 #include <array>
-#include <stack>
+#include <memory>
+#include <ostream>
 #include <spdlog/spdlog.h>
 #include <string>
 #include <cstdint>
 #include <random>
 
+#include "DeadlineSleeper.hpp"
+#include "DisplayView.hpp"
+#include "FramePacer.hpp"
+#include "GridRenderer.hpp"
+#include "Profiler.hpp"
+#include "RecompiledRom.hpp"
 #include "glad/gl.h"
 #include <GLFW/glfw3.h>
 #include "glm/glm.hpp"
@@ -15,26 +22,72 @@ bool init_emu();
 bool terminate_emu();
 std::string get_bin_representation(uint original);
 std::string get_hex_representation(uint original);
+std::string disassemble(uint16_t instruction);
 
 class Chip8 {
+    friend class RecompiledRuntime; // Native code generated by `chip8pp-aot`
+    friend struct LoadedProgram;    // Cached by `RomCache`
+
+    private: // Private constants
+        static const unsigned int PAGE_SIZE  = 256; ///< Bytes per RAM page
+        static const unsigned int PAGE_COUNT = 16;  ///< Pages in the 4KB of RAM
+        static const unsigned int STACK_SIZE = 16;  ///< Deepest nesting of subroutine calls
+
+    private: // Private types
+        /// Instruction sequences executed by a single handler in `run_cycles()`
+        enum class FusedOp : uint8_t {
+            NONE,       ///< Plain instruction, goes through `step()`
+            IDLE_JUMP,  ///< 1NNN jumping to itself
+            SET_ADD,    ///< 6XNN ; 7YNN
+            INDEX_DRAW, ///< ANNN ; DXYN
+            DELAY_WAIT, ///< FX07 ; 3XNN ; 1NNN
+            INDEX_LOAD, ///< ANNN ; FX1E ; FY65
+            NATIVE      ///< Unmodified block of a recompiled ROM
+        };
+
+        /// Slice of RAM with the fused sequence starting at each of its bytes, shared between cores until written
+        struct MemoryPage {
+            std::array<uint8_t, PAGE_SIZE> bytes;    ///< RAM contents
+            std::array<FusedOp, PAGE_SIZE> fusedOps; ///< Fused sequence starting at each byte
+        };
+
     private: // Private fields
-        std::string               name;              ///< Name/identifir (for logging)
-        std::array<uint8_t, 4096> ram;               ///< 4KB of RAM
-        std::array<uint8_t, 16>   variableRegisters; ///< V0-VF Variable registers 
+        std::string                                         name;              ///< Name/identifir (for logging)
+        std::array<std::shared_ptr<MemoryPage>, PAGE_COUNT> pages;             ///< 4KB of RAM, copied on write when shared
+        std::array<uint8_t, 16>                             variableRegisters; ///< V0-VF Variable registers 
+        const MemoryPage                                   *codePage;          ///< Page holding `pc` (cached `pages[codePageId]`)
+        uint16_t                                            codePageId;        ///< Index of `codePage`
 
-        std::mt19937                            randomEngine;       ///< Random Engine
+        std::shared_ptr<std::mt19937>           randomEngine;       ///< Random Engine, copied on use when shared
         std::uniform_int_distribution<uint32_t> randomDistribution; ///< Random distribution. Should be 0-255.
 
-        uint16_t             pc;            ///< Program Counter
-        uint16_t             indexRegister; ///< Index Register
-        std::stack<uint16_t> addressStack;  ///< Stack of call addresses
-        uint8_t              delayTimer;    ///< 60Hz - delay timer
-        uint8_t              soundTimer;    ///< Sound timer
-
-        GLFWwindow                           *display;      ///< Window where to display
-        std::array<std::array<bool, 32>, 64>  displayState; ///< 2D array representing the image to render
-
-        uint16_t rawInstruction; ///< Raw 16-bit instruction to be decoded
+        uint16_t                         pc;            ///< Program Counter
+        uint16_t                         indexRegister; ///< Index Register
+        std::array<uint16_t, STACK_SIZE> addressStack;  ///< Stack of call addresses
+        uint8_t                          stackSize;     ///< Addresses on `addressStack`
+        uint8_t                          delayTimer;    ///< 60Hz - delay timer
+        uint8_t                          soundTimer;    ///< Sound timer
+
+        GLFWwindow                           *display;             ///< Window where to display (NULL when headless)
+        uint16_t                              keypadState;         ///< Keys held on a headless core (bit N : CHIP-8 key N)
+        std::array<uint64_t, 32>              displayState;        ///< Image to render, one 64-bits word per row (MSB is the leftmost pixel)
+        uint64_t                              displayGeneration;   ///< Incremented on every CLS/DXYN
+        uint64_t                              frameHash;           ///< Cached hash of the display
+        uint64_t                              frameHashGeneration; ///< Display generation `frameHash` was computed at
+
+        uint16_t rawInstruction;   ///< Raw 16-bit instruction to be decoded
+        uint64_t instructionCount; ///< Instructions executed since construction
+        uint64_t collapsedCycles;  ///< Part of `instructionCount` that idle jumps and delay waits skipped without running
+
+        // Metrics, added to the thread's `MetricsShard` in batches
+        uint64_t reportedInstructions; ///< Part of `instructionCount` already reported
+        uint64_t reportedCollapsed;    ///< Part of `collapsedCycles` already reported
+        uint64_t pendingDrawOps;       ///< DXYN executed since the last report
+        uint64_t pendingFrames;        ///< Emulated frames run since the last report
+        uint64_t keyWaitStart;         ///< `Timeline::now()` when the pending FX0A started waiting, 0 if none is
+
+        bool                 fusionEnabled; ///< Whether `run_cycles()` uses the fused handlers and recompiled blocks
+        const RecompiledRom *recompiled;    ///< Native version of the loaded program (NULL if there is none)
 
         // Decoded instuction (every component is computed rregardless of the opcode)
         uint8_t  opcode;           ///< The 4-bits opcode to be executed
@@ -45,32 +98,72 @@ class Chip8 {
         uint16_t immediateAddress; ///< The 12-bits immediate address of the instruction
 
         // OpenGL-rendering-related fields
-        GLuint    vaoAddress;                      ///< Address of the pixel VAO
-        GLuint    programAddress;                  ///< Address of the main pixel rendering program
-        glm::vec4 pixelColor;                      ///< chosen pixel color
-        GLint     enabledColorUniformLocation;     ///< Location of the enabled color uniform
-        GLint     projectionMatrixUniformLocation; ///< Location of the projection matrix uniform
-        GLint     modelMatrixUniformLocation;      ///< Location of the model matrix uniform
+        std::unique_ptr<GridRenderer> renderer; ///< Draws `displayState` in the window (NULL when headless)
+
+        // Main loop pacing
+        FramePacer      pacer;           ///< Schedules emulated frames on host time
+        DeadlineSleeper sleeper;         ///< Waits for the next emulated frame
+        int             swapInterval;    ///< Screen refreshes per buffer swap (0 disables vsync)
+        unsigned int    frameCycles;     ///< Instructions executed per emulated frame
+        uint64_t        drawnGeneration; ///< Display generation on screen
+        bool            redrawRequested; ///< Whether the next frame must be drawn even if the display didn't change
+
+#ifdef CHIP8PP_PROFILE
+        // Guest profiling (only built with CHIP8PP_PROFILE)
+        std::array<uint64_t, 4096> pcCounts;     ///< Executions per program counter value
+        std::array<uint64_t, 16>   opcodeCounts; ///< Executions per opcode class (first nibble)
+        ProfileTimer               drawTimer;    ///< Ticks spent in DXYN
+        ProfileTimer               keyTimer;     ///< Ticks spent in EX9E / EXA1 / FX0A
+#endif
 
     public:  // Public functions
-        Chip8(const std::string &name);
+        Chip8(const std::string &name, bool headless = false);
+        ~Chip8();
         
+        std::unique_ptr<Chip8> fork() const;
         void load_program(const std::string &fileName);
+        void load_program(const uint8_t *program, size_t programSize);
         void run();
+        void step();
+        void run_cycles(uint64_t cycles);
+        void run_frames(unsigned int frames);
+        void tick_timers();
+
+        // Setters
+        void set_swap_interval(int swapInterval);
+        void set_refresh_rate(double refreshRate);
+        void set_frame_cycles(unsigned int frameCycles);
+        void set_fusion_enabled(bool fusionEnabled);
+        void set_keypad_state(uint16_t keypadState);
+        void set_random_seed(uint32_t seed);
 
         // Getters
-        std::array<std::array<bool, 32>, 64> get_display_state();
-        GLint get_model_matrix_uniform_location()      const;
+        DisplayView get_display_view()                 const;
+        uint64_t get_display_generation()              const;
+        uint64_t get_instruction_count()               const;
+        uint64_t get_collapsed_cycles()                const;
+        const RecompiledRom *get_recompiled_rom()      const;
+        bool is_halted()                               const;
+        uint8_t get_memory_byte(uint16_t address)      const;
+        uint64_t get_frame_hash();
+        uint64_t get_state_hash()                      const;
+        void print_profile_report(std::ostream &output, size_t hotspotCount = 20) const;
         GLint get_projection_matrix_uniform_location() const;
         GLint get_enabled_color_uniform_location()     const;
         GLint get_program_address()                    const;
 
     private: // Private functions
+        Chip8(const Chip8 &parent);
+
         // I/O
-        char read(const uint16_t &address);
-        void write(const uint16_t &address, const uint8_t &value);
+        uint8_t     read(uint16_t address) const;
+        void        write(uint16_t address, uint8_t value);
+        MemoryPage &writable_page(uint16_t address);
+        const MemoryPage &code_page();
+        int         poll_key(int glfwKey);
 
         // Fetch-Decode-Execute cycle
+        void execute_cycles(uint64_t cycles);
         void fetch();
         void decode();
         void execute();
@@ -112,11 +205,27 @@ class Chip8 {
         void memory_store();
         void memory_load();
 
+        // Fused operations (each returns the number of instructions it stands for)
+        uint64_t fused_idle_jump(uint64_t budget);
+        uint64_t fused_set_add();
+        uint64_t fused_index_draw();
+        uint64_t fused_delay_wait(uint64_t budget);
+        uint64_t fused_index_load();
 
         // Meta-operations
         void update_display();
+        void refresh_fused_ops(int first, int last);
+        void share_pages();
+        void report_metrics();
+        void push_address(uint16_t address);
+        uint16_t pop_address();
+        FusedOp get_fused_op(uint16_t address) const;
+        FusedOp classify_fused_op(uint16_t address) const;
+        bool    is_native_block(uint16_t address) const;
 
     private: // Private static functions
+        static const std::shared_ptr<MemoryPage> &zero_page();
+        static const std::shared_ptr<MemoryPage> &font_page();
         static void glfw_error_callback(int error, const char *description);
         static void glfw_frame_size_callback(GLFWwindow *window, int width, int height);
         static void glfw_key_callback(GLFWwindow *window, int key, int scancode, int action, int mods);
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/socket.h>
+
+/**
+ * Non-blocking datagram socket talking to a single peer, over UDP or a Unix domain socket.
+ *
+ * Addresses are `udp:HOST:PORT` or `unix:PATH`, the same kind on both ends. The local address is
+ * bound on construction; a Unix socket file left over by a previous run is replaced, and removed
+ * on destruction. Datagrams aren't filtered by sender : the protocol on top must recognize its own.
+ */
+class DatagramSocket {
+    private: // Private fields
+        int                     fileDescriptor; ///< Bound socket
+        std::string             unixPath;       ///< Socket file to remove on destruction (empty for UDP)
+        struct sockaddr_storage peer;           ///< Where `send()` goes
+        socklen_t               peerSize;       ///< Meaningful bytes of `peer`
+
+    public:  // Public functions
+        DatagramSocket(const std::string &localAddress, const std::string &remoteAddress);
+        ~DatagramSocket();
+
+        DatagramSocket(const DatagramSocket &) = delete;
+        DatagramSocket &operator=(const DatagramSocket &) = delete;
+
+        bool send(const uint8_t *data, size_t size);
+        long receive(uint8_t *buffer, size_t capacity);
+        bool wait(int timeoutMs);
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * Sleeps until absolute deadlines on the monotonic clock, precisely and without burning a core.
+ *
+ * The thread sleeps with `clock_nanosleep(TIMER_ABSTIME)` until `spinTail` before the deadline, then
+ * spins for the rest, which absorbs the scheduler's wake-up latency. How late every wake-up was is
+ * kept in a log2 histogram, so the achieved jitter can be reported.
+ */
+class DeadlineSleeper {
+    private: // Private constants
+        static const size_t BUCKET_COUNT = 24; ///< Lateness buckets : [0, 1us), [1, 2us), [2, 4us)... up to ~4s
+
+    private: // Private fields
+        double                             spinTail;        ///< Seconds spent spinning before each deadline
+        uint64_t                           wakeups;         ///< Sleeps that reached their deadline
+        uint64_t                           overruns;        ///< Calls made after their deadline had passed
+        double                             totalLateness;   ///< Sum of the wake-up lateness, in seconds
+        double                             maxLateness;     ///< Worst wake-up lateness, in seconds
+        std::array<uint64_t, BUCKET_COUNT> latenessBuckets; ///< Wake-ups per lateness range
+
+    public:  // Public functions
+        explicit DeadlineSleeper(double spinTail = 0.0002);
+
+        static double now();
+
+        void sleep_until(double deadline);
+        void print_report(std::ostream &output) const;
+
+        // Setters
+        void set_spin_tail(double spinTail);
+
+        // Getters
+        uint64_t get_wakeup_count()                        const;
+        uint64_t get_overrun_count()                       const;
+        double   get_mean_lateness()                       const;
+        double   get_max_lateness()                        const;
+        double   get_lateness_percentile(double percentile) const;
+};
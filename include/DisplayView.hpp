@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Read-only, non-owning view over a packed 64x32 display.
+ *
+ * Each row is one 64-bits word whose most significant bit is the leftmost pixel. Rows are `stride`
+ * words apart, so a view can also point into a larger buffer (e.g. a batch of instances). The view
+ * stays valid as long as its owner lives; `generation` tells which display update it was taken at.
+ */
+struct DisplayView {
+    static const unsigned int WIDTH  = 64; ///< Pixels per row
+    static const unsigned int HEIGHT = 32; ///< Rows
+
+    const uint64_t *rows;       ///< First row
+    size_t          stride;     ///< Distance between two rows, in words
+    uint64_t        generation; ///< Number of display updates (CLS/DXYN) when the view was taken
+
+    uint64_t row(unsigned int y) const {
+        return this->rows[y * this->stride];
+    }
+
+    bool pixel(unsigned int x, unsigned int y) const {
+        return (this->row(y) >> (63 - x)) & 1;
+    }
+};
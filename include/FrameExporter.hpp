@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DisplayView.hpp"
+
+/**
+ * Streams emulated frames to a file (or stdout with `-`) as YUV4MPEG2 or raw RGB24.
+ *
+ * Frames are copied into a fixed pool of packed slots by `submit()` and converted/written by a
+ * background worker, so the emulation thread never waits on I/O. When the pool is full the frame
+ * is dropped rather than blocking, unless the caller opts in to `wait_for_slot()` (offline runs).
+ * Only one thread may call `submit()`.
+ */
+class FrameExporter {
+    public: // Public types
+        enum class Format {
+            Y4M, ///< YUV4MPEG2, 4:2:0 (what ffmpeg expects on a pipe)
+            RGB  ///< Headerless RGB24 frames
+        };
+
+    private: // Private fields
+        std::FILE   *output;     ///< Destination stream
+        bool         ownsOutput; ///< Whether `output` must be closed (false for stdout)
+        Format       format;     ///< Output container
+        unsigned int scale;      ///< Size of an emulated pixel, in output pixels
+        unsigned int frameRate;  ///< Advertised frame rate (Y4M only)
+
+        std::vector<std::array<uint64_t, 32>> slots;        ///< Pooled packed frames
+        std::atomic<uint64_t>                 writeCursor;  ///< Next slot to fill (producer-owned)
+        std::atomic<uint64_t>                 readCursor;   ///< Next slot to encode (worker-owned)
+        std::vector<uint8_t>                  encodeBuffer; ///< Reused conversion buffer
+
+        uint64_t              lastHash;         ///< Hash of the last submitted frame
+        bool                  hasLastHash;      ///< Whether `lastHash` is meaningful
+        std::atomic<uint64_t> writtenFrames;    ///< Frames written to the output
+        uint64_t              duplicateFrames;  ///< Frames skipped because identical to the previous one
+        uint64_t              overflowFrames;   ///< Frames dropped because the pool was full
+
+        std::thread             worker;    ///< Encoding thread
+        std::mutex              wakeMutex; ///< Only guards the worker's sleep
+        std::condition_variable wake;      ///< Signaled when frames are queued or on shutdown
+        std::atomic<bool>       stopping;  ///< Set by `finish()`
+
+    public:  // Public functions
+        FrameExporter(const std::string &path, Format format, unsigned int scale = 8, unsigned int frameRate = 60, unsigned int poolSize = 16);
+        ~FrameExporter();
+
+        FrameExporter(const FrameExporter &) = delete;
+        FrameExporter &operator=(const FrameExporter &) = delete;
+
+        bool submit(const DisplayView &view, uint64_t hash);
+        void wait_for_slot();
+        void finish();
+
+        // Getters
+        uint64_t get_written_frames()   const;
+        uint64_t get_duplicate_frames() const;
+        uint64_t get_overflow_frames()  const;
+
+    private: // Private functions
+        void write_header();
+        void encode(const std::array<uint64_t, 32> &rows);
+        void worker_loop();
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Keeps emulated time in step with host time for the window's main loop.
+ *
+ * Emulated frames are due every `1 / refreshRate` seconds of host time. `frames_due()` tells the
+ * loop how many to run before rendering : more than one means the host fell behind and the frames
+ * in between are emulated but never drawn (frame skipping). Past `maxCatchUpFrames` the remaining
+ * debt is dropped, so a host that can't keep up runs slower instead of spiraling.
+ */
+class FramePacer {
+    private: // Private fields
+        double       frameDuration;    ///< Host seconds per emulated frame
+        unsigned int maxCatchUpFrames; ///< Most emulated frames run for one rendered frame
+        double       nextFrameTime;    ///< Host time the next emulated frame is due at
+        uint64_t     emulatedFrames;   ///< Emulated frames run so far
+        uint64_t     renderedFrames;   ///< Frames actually presented (`frame_presented()`)
+        uint64_t     skippedFrames;    ///< Emulated frames that were never drawn
+        uint64_t     droppedFrames;    ///< Emulated frames given up to catch up with host time
+
+    public:  // Public functions
+        FramePacer(double refreshRate = 60.0, unsigned int maxCatchUpFrames = 4);
+
+        void         reset(double now);
+        unsigned int frames_due(double now);
+        void         frame_presented();
+
+        // Setters
+        void set_refresh_rate(double refreshRate);
+        void set_max_catch_up_frames(unsigned int maxCatchUpFrames);
+
+        // Getters
+        double   get_next_frame_time()  const;
+        double   get_refresh_rate()     const;
+        uint64_t get_emulated_frames()  const;
+        uint64_t get_rendered_frames()  const;
+        uint64_t get_skipped_frames()   const;
+        uint64_t get_dropped_frames()   const;
+};
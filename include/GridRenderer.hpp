@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "DisplayView.hpp"
+#include "glad/gl.h"
+#include "glm/glm.hpp"
+
+/**
+ * Draws a packed 64x32 display with the `grid` shaders into the framebuffer bound in the current
+ * OpenGL context (the window's default framebuffer, or an offscreen one).
+ *
+ * The display rows are streamed through a persistently mapped shader storage buffer split in a few
+ * fenced regions (one written while the GPU may still read the others), and every pixel is drawn
+ * by a single instanced draw call. The OpenGL context (4.4 or later) must be current when the
+ * renderer is created, used and destroyed.
+ */
+class GridRenderer {
+    private: // Private constants
+        static const size_t REGION_COUNT  = 3;       ///< Regions of the display state buffer
+        static const size_t DISPLAY_BYTES = 64*32/8; ///< Packed display size
+
+    private: // Private fields
+        GLuint    vaoAddress;                      ///< Address of the pixel VAO
+        GLuint    vboAddress;                      ///< Address of the pixel square vertices
+        GLuint    eboAddress;                      ///< Address of the pixel square indices
+        GLuint    programAddress;                  ///< Address of the main pixel rendering program
+        glm::vec4 pixelColor;                      ///< chosen pixel color
+        GLint     enabledColorUniformLocation;     ///< Location of the enabled color uniform
+        GLint     projectionMatrixUniformLocation; ///< Location of the projection matrix uniform
+
+        GLuint                           displayBufferAddress; ///< Display state buffer (REGION_COUNT regions)
+        uint8_t                         *displayMapping;       ///< Persistent mapping of the whole buffer
+        size_t                           regionSize;           ///< Distance between regions (DISPLAY_BYTES, aligned)
+        std::array<GLsync, REGION_COUNT> regionFences;         ///< Last draw reading each region (NULL when none)
+        size_t                           currentRegion;        ///< Region holding the last uploaded display
+        const uint64_t                  *uploadedRows;         ///< Display the current region was uploaded from
+        uint64_t                         uploadedGeneration;   ///< Generation the current region was uploaded at
+
+    public:  // Public functions
+        GridRenderer();
+        ~GridRenderer();
+
+        GridRenderer(const GridRenderer &) = delete;
+        GridRenderer &operator=(const GridRenderer &) = delete;
+
+        void draw(const DisplayView &view);
+
+        // Getters
+        GLint get_projection_matrix_uniform_location() const;
+        GLint get_enabled_color_uniform_location()     const;
+        GLint get_program_address()                    const;
+
+    private: // Private functions
+        void upload(const DisplayView &view);
+        void delete_objects();
+};
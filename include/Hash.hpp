@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// XXH64-compatible hashing. Both functions produce the same value as the reference XXH64
+// over the little-endian byte representation of their input, whatever the host endianness.
+uint64_t xxhash64(const void *data, size_t length, uint64_t seed = 0);
+uint64_t xxhash64_words(const uint64_t *words, size_t count, uint64_t seed = 0);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * HDR-style histogram of durations in nanoseconds, for tail latencies.
+ *
+ * Buckets are log-linear : every power of two is split into `SUB_BUCKETS` equal buckets, so any
+ * recorded value is known within 1/64 (1.6%) whatever its magnitude, from 1 ns up to `2^MAX_EXPONENT`
+ * ns (about 18 minutes; longer values land in the last bucket). Recording is a few shifts and an
+ * increment, without allocation.
+ */
+class LatencyHistogram {
+    public: // Public constants
+        static const unsigned int SUB_BUCKET_BITS = 6;                    ///< log2 of the buckets per power of two
+        static const unsigned int SUB_BUCKETS     = 1 << SUB_BUCKET_BITS; ///< Buckets per power of two
+        static const unsigned int MAX_EXPONENT    = 40;                   ///< Values from 2^40 ns are clamped
+
+    private: // Private fields
+        std::vector<uint64_t> counts; ///< Recorded values per bucket
+        uint64_t              total;  ///< Recorded values
+        uint64_t              sum;    ///< Sum of the recorded values
+        uint64_t              min;    ///< Smallest recorded value
+        uint64_t              max;    ///< Largest recorded value
+
+    public:  // Public functions
+        LatencyHistogram();
+
+        void record(uint64_t nanoseconds);
+        void reset();
+
+        // Getters
+        uint64_t get_count()                       const;
+        uint64_t get_min()                         const;
+        uint64_t get_max()                         const;
+        double   get_mean()                        const;
+        uint64_t get_percentile(double percentile) const;
+
+    private: // Private functions
+        static size_t   bucket_of(uint64_t nanoseconds);
+        static uint64_t highest_value_of(size_t bucket);
+};
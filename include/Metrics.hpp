@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// Distribution of durations over fixed buckets
+struct MetricsHistogram {
+    static const size_t BUCKET_COUNT = 13; ///< `Metrics::BUCKET_BOUNDS`, then +Inf
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets; ///< Observations per bucket (not cumulative)
+    std::atomic<uint64_t>                           sumNs;   ///< Sum of the observations, in nanoseconds
+};
+
+/// Counters of one thread. Only that thread writes them; scrapes read them at any time
+struct MetricsShard {
+    std::atomic<uint64_t> instructions;    ///< Guest instructions executed
+    std::atomic<uint64_t> collapsedCycles; ///< Part of `instructions` that fused idle jumps and delay waits skipped
+    std::atomic<uint64_t> emulatedFrames;  ///< Emulated frames run
+    std::atomic<uint64_t> renderedFrames;  ///< Frames presented in a window
+    std::atomic<uint64_t> keyEvents;       ///< Key presses and releases
+    std::atomic<uint64_t> drawOps;         ///< DXYN executed
+    std::atomic<uint64_t> coresCreated;    ///< Cores constructed or forked
+    std::atomic<uint64_t> coresDestroyed;  ///< Cores destroyed
+
+    MetricsHistogram frameTime;    ///< Host time between two presented frames
+    MetricsHistogram emulationLag; ///< How late emulated frames start after their deadline
+};
+
+/**
+ * Process-wide emulator metrics, rendered in the Prometheus text format.
+ *
+ * Every thread updates a shard of its own with relaxed loads and stores (no locked instruction),
+ * and `render()` sums the shards with relaxed reads. Scraping thus never waits on nor slows down an
+ * emulation thread; the mutex is only taken when a thread records its first metric, when it exits
+ * (its shard is kept for the next thread) and by `render()`.
+ */
+class Metrics {
+    public: // Public constants
+        static const std::array<double, MetricsHistogram::BUCKET_COUNT - 1> BUCKET_BOUNDS; ///< Upper bounds of the histogram buckets, in seconds
+
+    private: // Private types
+        struct ShardLease;
+
+    private: // Private fields
+        std::mutex                                 mutex;      ///< Guards both lists
+        std::vector<std::unique_ptr<MetricsShard>> shards;     ///< Every shard ever handed out
+        std::vector<MetricsShard *>                freeShards; ///< Shards of threads that exited
+
+    public:  // Public functions
+        static Metrics &instance();
+        static MetricsShard &local();
+
+        static void add(std::atomic<uint64_t> &counter, uint64_t amount);
+        static void observe(MetricsHistogram &histogram, double seconds);
+
+        std::string render();
+
+    private: // Private functions
+        Metrics();
+
+        MetricsShard *acquire_shard();
+        void release_shard(MetricsShard *shard);
+};
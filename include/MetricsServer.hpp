@@ -0,0 +1,30 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+/**
+ * Serves `Metrics` to Prometheus over HTTP (`GET /metrics`) from a thread of its own.
+ *
+ * Listens on `tcp:HOST:PORT` or `unix:PATH` (see `SocketAddress.hpp`). Scrapes are answered one at
+ * a time and every connection is closed after its response. Emulation threads never wait on it.
+ */
+class MetricsServer {
+    private: // Private fields
+        int               listener; ///< Listening socket
+        std::string       unixPath; ///< Socket file to remove on destruction (empty for TCP)
+        std::atomic<bool> stopping; ///< Set by the destructor
+        std::thread       thread;   ///< Accepts and answers scrapes
+
+    public:  // Public functions
+        explicit MetricsServer(const std::string &address);
+        ~MetricsServer();
+
+        MetricsServer(const MetricsServer &) = delete;
+        MetricsServer &operator=(const MetricsServer &) = delete;
+
+    private: // Private functions
+        void serve();
+        void answer(int connection);
+};
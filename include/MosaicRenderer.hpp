@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "DisplayView.hpp"
+#include "glad/gl.h"
+#include "glm/glm.hpp"
+
+/**
+ * Draws the displays of many cores as a grid of tiles, in a single instanced draw call (one
+ * instance per tile, the fragment shader reads the pixel bits).
+ *
+ * Every display lives in a persistently mapped shader storage buffer split in a few fenced regions,
+ * like GridRenderer. Only the displays whose generation changed since a region was last written are
+ * copied into it, so the cost of a frame follows the number of active cores rather than their count.
+ * `views[i]` must always show the same core, since displays are told apart by their generation.
+ * The OpenGL context (4.4 or later) must be current when the renderer is created, used and destroyed.
+ */
+class MosaicRenderer {
+    private: // Private constants
+        static const size_t REGION_COUNT  = 3;       ///< Regions of the display state buffer
+        static const size_t DISPLAY_BYTES = 64*32/8; ///< Packed display size
+
+    private: // Private fields
+        size_t       instanceCount; ///< Number of tiles
+        unsigned int columns;       ///< Tiles per row
+        unsigned int rows;          ///< Tile rows
+
+        GLuint    vaoAddress;                  ///< Address of the tile VAO
+        GLuint    vboAddress;                  ///< Address of the tile square vertices
+        GLuint    eboAddress;                  ///< Address of the tile square indices
+        GLuint    programAddress;              ///< Address of the mosaic program
+        glm::vec4 pixelColor;                  ///< Color of the enabled pixels
+        GLint     enabledColorUniformLocation; ///< Location of the enabled color uniform
+
+        GLuint                                          displayBufferAddress; ///< Display state buffer (REGION_COUNT regions)
+        uint8_t                                        *displayMapping;       ///< Persistent mapping of the whole buffer
+        size_t                                          regionSize;           ///< Distance between regions (aligned)
+        std::array<GLsync, REGION_COUNT>                regionFences;         ///< Last draw reading each region (NULL when none)
+        std::array<std::vector<uint64_t>, REGION_COUNT> regionGenerations;    ///< Generation of every display in each region
+        size_t                                          currentRegion;        ///< Region read by the last draw
+        size_t                                          lastUploadCount;      ///< Displays copied by the last draw
+
+    public:  // Public functions
+        MosaicRenderer(size_t instanceCount, unsigned int columns = 0);
+        ~MosaicRenderer();
+
+        MosaicRenderer(const MosaicRenderer &) = delete;
+        MosaicRenderer &operator=(const MosaicRenderer &) = delete;
+
+        void draw(const DisplayView *views);
+
+        // Getters
+        size_t       get_instance_count()    const;
+        unsigned int get_columns()           const;
+        unsigned int get_rows()              const;
+        size_t       get_last_upload_count() const;
+
+    private: // Private functions
+        void delete_objects();
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "glad/gl.h"
+
+/**
+ * Window-less OpenGL 4.4 core context, created through EGL (e.g. Mesa's llvmpipe on machines
+ * without a display or GPU), rendering into an RGBA8 framebuffer object of a fixed size.
+ *
+ * The surfaceless platform and `EGL_KHR_surfaceless_context` are used when available, otherwise
+ * the context is bound to a 1x1 pbuffer. The context is made current on the creating thread.
+ */
+class OffscreenContext {
+    private: // Private fields
+        void        *eglDisplay;          ///< EGLDisplay
+        void        *eglContext;          ///< EGLContext
+        void        *eglSurface;          ///< EGLSurface (EGL_NO_SURFACE when surfaceless)
+        GLuint       framebufferAddress;  ///< Offscreen render target
+        GLuint       renderbufferAddress; ///< Color attachment of the render target
+        unsigned int width;               ///< Render target width, in pixels
+        unsigned int height;              ///< Render target height, in pixels
+
+    public:  // Public functions
+        OffscreenContext(unsigned int width, unsigned int height);
+        ~OffscreenContext();
+
+        OffscreenContext(const OffscreenContext &) = delete;
+        OffscreenContext &operator=(const OffscreenContext &) = delete;
+
+        void make_current();
+        void read_pixels(uint8_t *rgba);
+
+        // Getters
+        unsigned int get_width()          const;
+        unsigned int get_height()         const;
+        size_t       get_frame_size()     const;
+        GLuint       get_framebuffer()    const;
+        const char  *get_renderer_name()  const;
+
+    private: // Private functions
+        void release();
+};
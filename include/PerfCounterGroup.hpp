@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// Totals read from a `PerfCounterGroup`, scaled up when the kernel multiplexed the counters
+struct PerfCounts {
+    std::array<double, 4> values;    ///< One per `PerfCounterGroup::Counter`
+    std::array<bool, 4>   available; ///< Whether the host could count it at all
+};
+
+/**
+ * Hardware counters of the calling thread (Linux `perf_event_open`), read as one group so that they
+ * cover exactly the same instructions : cycles, instructions, branch misses and L1d read misses.
+ *
+ * Only user-space execution is counted. Opening fails with an exception when the host has no PMU
+ * or forbids it (`kernel.perf_event_paranoid`, containers, virtual machines, other systems); counters
+ * the CPU doesn't have, typically the L1d one, are left out of the group and marked unavailable.
+ */
+class PerfCounterGroup {
+    public: // Public types
+        enum Counter {
+            CYCLES,
+            INSTRUCTIONS,
+            BRANCH_MISSES,
+            L1D_MISSES,
+            COUNTER_COUNT
+        };
+
+    public: // Public constants
+        static const char *const COUNTER_NAMES[COUNTER_COUNT]; ///< Short names, as in `perf stat`
+
+    private: // Private fields
+        std::array<int, COUNTER_COUNT> fileDescriptors; ///< -1 for counters left out; the first one leads the group
+        size_t                         openCounters;    ///< Counters in the group
+
+    public:  // Public functions
+        PerfCounterGroup();
+        ~PerfCounterGroup();
+
+        PerfCounterGroup(const PerfCounterGroup &) = delete;
+        PerfCounterGroup &operator=(const PerfCounterGroup &) = delete;
+
+        void start();
+        PerfCounts stop();
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * Guest profiling helpers. Everything here is only referenced through the `CHIP8_PROFILE_*` macros,
+ * which expand to nothing unless the build defines `CHIP8PP_PROFILE`.
+ */
+
+/// Cheap monotonic tick counter : TSC on x86, nanoseconds elsewhere
+inline uint64_t profile_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/// Accumulated calls and ticks of a profiled operation
+struct ProfileTimer {
+    uint64_t calls; ///< Number of timed executions
+    uint64_t ticks; ///< Total ticks spent
+};
+
+/// Adds the ticks spent in its scope to a ProfileTimer
+class ProfileScope {
+    private: // Private fields
+        ProfileTimer &timer; ///< Destination
+        uint64_t      start; ///< Ticks at construction
+
+    public:  // Public functions
+        explicit ProfileScope(ProfileTimer &timer) : timer(timer), start(profile_ticks()) {}
+
+        ~ProfileScope() {
+            this->timer.ticks += profile_ticks() - this->start;
+            ++this->timer.calls;
+        }
+};
+
+#ifdef CHIP8PP_PROFILE
+    #define CHIP8_PROFILE_COUNT(counters, index) (++(counters)[(index)])
+    #define CHIP8_PROFILE_SCOPE(timer)           ProfileScope profileScope(timer)
+#else
+    #define CHIP8_PROFILE_COUNT(counters, index) ((void)0)
+    #define CHIP8_PROFILE_SCOPE(timer)           ((void)0)
+#endif
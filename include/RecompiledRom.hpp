@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Chip8;
+
+/**
+ * Runs the recompiled block starting at `address` if all of its instructions fit in `budget`.
+ * Returns the number of instructions executed, 0 when nothing was run (the interpreter takes over).
+ */
+typedef uint64_t (*RecompiledDispatch)(Chip8 &core, uint16_t address, uint64_t budget);
+
+/// Guest code range translated to one native function
+struct RecompiledBlock {
+    uint16_t address; ///< First instruction
+    uint16_t size;    ///< Bytes of guest code covered
+};
+
+/// ROM translated to C++ by `chip8pp-aot`
+struct RecompiledRom {
+    const char            *title;        ///< Name of the ROM file it was generated from
+    const uint8_t         *image;        ///< Program bytes the code was generated from, as loaded at 0x200
+    size_t                 imageSize;    ///< Size of `image`
+    const RecompiledBlock *blocks;       ///< Translated blocks, sorted by address
+    size_t                 blockCount;   ///< Number of entries in `blocks`
+    uint16_t               maxBlockSize; ///< Size of the largest block
+    RecompiledDispatch     dispatch;     ///< Entry point of the native code
+};
+
+/**
+ * Process-wide list of recompiled ROMs, looked up by content when a program is loaded.
+ *
+ * Generated units register themselves from a static `RecompiledRomRegistrar`, so they only need
+ * to be linked in (or loaded as plugins with `load_plugin()`). Thread-safe.
+ */
+class RecompiledRomRegistry {
+    private: // Private fields
+        std::mutex                                                       mutex;  ///< Guards `byHash`
+        std::unordered_map<uint64_t, std::vector<const RecompiledRom *>> byHash; ///< XXH64 of the image to ROMs
+
+    public:  // Public functions
+        static RecompiledRomRegistry &instance();
+
+        void                 add(const RecompiledRom *rom);
+        const RecompiledRom *find(const uint8_t *program, size_t programSize);
+        void                 load_plugin(const std::string &fileName);
+
+    private: // Private functions
+        RecompiledRomRegistry();
+};
+
+/// Registers a generated ROM during static initialization
+struct RecompiledRomRegistrar {
+    explicit RecompiledRomRegistrar(const RecompiledRom *rom) {
+        RecompiledRomRegistry::instance().add(rom);
+    }
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Chip8.hpp"
+#include "RecompiledRom.hpp"
+
+/**
+ * What code generated by `chip8pp-aot` may touch in a core.
+ *
+ * Everything is inline so the compiler sees straight through the accessors. Instructions with
+ * side effects beyond registers (drawing, keys, random numbers, memory writes) go through
+ * `interpret()`, which runs the interpreter's own handler for them.
+ */
+class RecompiledRuntime {
+    public:  // Public functions
+        static uint8_t read(const Chip8 &core, uint16_t address) {
+            return core.pages[address / Chip8::PAGE_SIZE % Chip8::PAGE_COUNT]->bytes[address % Chip8::PAGE_SIZE];
+        }
+
+        static uint8_t *registers(Chip8 &core) {
+            return core.variableRegisters.data();
+        }
+
+        static uint16_t &pc(Chip8 &core) {
+            return core.pc;
+        }
+
+        static uint16_t &index(Chip8 &core) {
+            return core.indexRegister;
+        }
+
+        static uint8_t &delay_timer(Chip8 &core) {
+            return core.delayTimer;
+        }
+
+        static uint8_t &sound_timer(Chip8 &core) {
+            return core.soundTimer;
+        }
+
+        /// 2NNN at `address`
+        static void call(Chip8 &core, uint16_t address, uint16_t target) {
+            core.push_address(address);
+            core.pc = target;
+        }
+
+        /// 00EE
+        static void ret(Chip8 &core) {
+            core.pc = core.pop_address() + 2;
+        }
+
+        /// Executes `instruction` at `address` with the interpreter (leaves `pc` where the handler put it)
+        static void interpret(Chip8 &core, uint16_t address, uint16_t instruction) {
+            core.pc             = address;
+            core.rawInstruction = instruction;
+            core.decode();
+            core.execute();
+        }
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Chip8.hpp"
+
+/**
+ * One side of a two-player game with rollback netcode.
+ *
+ * Every frame runs as soon as the local input is known, predicting that the remote player still
+ * holds the keys of their last known input. When the real remote input of a frame turns out to
+ * differ, the core is restored from the fork taken at the start of that frame and the frames since
+ * are simulated again. `advance()` refuses to get more than `maxRollback` frames ahead of the last
+ * confirmed remote input. The keypad of a frame holds the keys of both players.
+ *
+ * Packets carry every local input the peer has not acknowledged yet, so a lost datagram is made up
+ * for by the next one, and the state hash of the latest frame whose inputs are all confirmed, so
+ * each side notices when the other one diverged. The session does no I/O : packets are written
+ * and read by the caller, whatever the transport.
+ */
+class RollbackSession {
+    public: // Public constants
+        static const unsigned int MAX_ROLLBACK    = 60;                             ///< Longest rollback window (one second of frames)
+        static const unsigned int MAX_INPUTS      = 128;                            ///< Inputs carried by one packet
+        static const size_t       MAX_PACKET_SIZE = 4 + 3*4 + 8 + 1 + 2*MAX_INPUTS; ///< Size of the largest packet
+
+    private: // Private constants
+        static const unsigned int HISTORY_SIZE = 256; ///< Frames kept in the rings below (more than the inputs in flight)
+
+    private: // Private fields
+        std::unique_ptr<Chip8>              core;            ///< State at the start of frame `frame`
+        std::vector<std::unique_ptr<Chip8>> snapshots;       ///< State at the start of each recent frame
+        std::vector<uint16_t>               localInputs;     ///< Keys held by the local player in each recent frame
+        std::vector<uint16_t>               remoteInputs;    ///< Keys of the remote player in each recent frame, confirmed or predicted
+        std::vector<uint64_t>               stateHashes;     ///< State hash at the start of each recent confirmed frame
+        unsigned int                        maxRollback;     ///< Frames run ahead of the confirmed remote input, at most
+
+        int64_t frame;           ///< Frames simulated so far
+        int64_t remoteConfirmed; ///< Last frame whose remote input is known (-1 : none)
+        int64_t remoteAck;       ///< Last frame of local input the peer has received (-1 : none)
+        int64_t hashedFrame;     ///< Last frame whose starting state is final and hashed (-1 : none)
+        int64_t mispredicted;    ///< First frame simulated with a wrong remote input (-1 : none)
+
+        int64_t  remoteHashFrame; ///< Frame of the last state hash sent by the peer (-1 : none)
+        uint64_t remoteHash;      ///< State hash sent by the peer
+        int64_t  desyncFrame;     ///< First frame both sides hashed differently (-1 : none)
+
+        uint64_t rollbacks;         ///< Restores done since the start
+        uint64_t resimulatedFrames; ///< Frames simulated again since the start
+
+    public:  // Public functions
+        RollbackSession(const Chip8 &initial, unsigned int maxRollback = 8);
+
+        bool advance(uint16_t localInput);
+        size_t write_packet(uint8_t *packet) const;
+        bool read_packet(const uint8_t *packet, size_t size);
+
+        // Getters
+        const Chip8 &get_core()             const;
+        int64_t  get_frame()                const;
+        int64_t  get_confirmed_frame()      const;
+        int64_t  get_acknowledged_frame()   const;
+        int64_t  get_hashed_frame()         const;
+        uint64_t get_hash(int64_t frame)    const;
+        int64_t  get_remote_hash_frame()    const;
+        int64_t  get_desync_frame()         const;
+        uint64_t get_rollbacks()            const;
+        uint64_t get_resimulated_frames()   const;
+
+    private: // Private functions
+        void simulate_frame();
+        void roll_back();
+        void hash_confirmed_frames();
+        void check_remote_hash();
+
+        static size_t slot(int64_t frame);
+};
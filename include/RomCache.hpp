@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+#include <vector>
+
+struct LoadedProgram; // Defined by `Chip8`
+
+/// Immutable content of a ROM file
+struct RomImage {
+    uint64_t             hash;  ///< XXH64 of the content
+    std::vector<uint8_t> bytes; ///< Program bytes, as loaded at 0x200
+
+    mutable std::shared_ptr<const LoadedProgram> loaded; ///< Memory of a core that just loaded it, guarded by the cache
+};
+
+/**
+ * Process-wide, read-only cache of ROM images.
+ *
+ * Files are read once with a single `read()`; identical contents share one image (keyed by their
+ * hash) whatever the path they came from. Later loads of an unchanged file (same inode, size and
+ * modification time) only cost a `stat()`. The memory the first core built from an image (pages,
+ * fused table, recompiled code) is kept with it, so later cores install it by copying page pointers.
+ * Thread-safe.
+ */
+class RomCache {
+    private: // Private types
+        struct FileEntry {
+            dev_t   device;           ///< Device of the file when it was read
+            ino_t   inode;            ///< Inode of the file when it was read
+            off_t   size;             ///< Size of the file when it was read
+            int64_t modificationTime; ///< Modification time (ns) of the file when it was read
+
+            std::shared_ptr<const RomImage> image; ///< Cached content
+        };
+
+    private: // Private fields
+        std::mutex                                                  mutex;     ///< Guards both maps
+        std::map<std::string, FileEntry>                            byPath;    ///< Path to last known file state
+        std::unordered_map<uint64_t, std::shared_ptr<const RomImage>> byContent; ///< Hash to shared image
+
+    public:  // Public functions
+        static RomCache &instance();
+
+        std::shared_ptr<const RomImage> load(const std::string &fileName);
+        std::shared_ptr<const RomImage> intern(const uint8_t *bytes, size_t size);
+        std::shared_ptr<const LoadedProgram> get_loaded_program(const RomImage &image);
+        void set_loaded_program(const RomImage &image, const std::shared_ptr<const LoadedProgram> &loaded);
+        void clear();
+
+    private: // Private functions
+        RomCache();
+
+        std::shared_ptr<const RomImage> intern_locked(std::vector<uint8_t> &&bytes);
+};
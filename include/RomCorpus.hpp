@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Packed ROM corpus (`.c8pack`) : a single file holding many ROMs, opened with one `mmap()`.
+ *
+ * Layout (little-endian, every section 8-bytes aligned) :
+ *   - CorpusHeader
+ *   - CorpusEntry[entryCount], sorted by content hash (binary searched)
+ *   - uint32_t[entryCount], entry ids sorted by title (binary searched)
+ *   - titles, concatenated without separator
+ *   - ROM blobs
+ */
+
+enum class RomPlatform : uint8_t {
+    CHIP8     = 0, ///< Original instruction set
+    SUPERCHIP = 1, ///< Uses SCHIP-only instructions (scrolling, hi-res, RPL flags)
+    XOCHIP    = 2  ///< Uses XO-CHIP-only instructions or doesn't fit 3.5 KB
+};
+
+/// Quirk-sensitive instructions found in a ROM (bit flags)
+enum RomQuirk : uint8_t {
+    QUIRK_SHIFT  = 1 << 0, ///< 8XY6 / 8XYE : shift VX or VY
+    QUIRK_JUMP   = 1 << 1, ///< BNNN : offset by V0 or VX
+    QUIRK_MEMORY = 1 << 2, ///< FX55 / FX65 : increment I or not
+    QUIRK_LOGIC  = 1 << 3  ///< 8XY1 / 8XY2 / 8XY3 : reset VF or not
+};
+
+struct CorpusHeader {
+    char     magic[8];         ///< "C8CORPUS"
+    uint32_t version;          ///< Format version
+    uint32_t entryCount;       ///< Number of ROMs
+    uint64_t entriesOffset;    ///< Offset of the hash-sorted entries
+    uint64_t titleIndexOffset; ///< Offset of the title-sorted entry ids
+    uint64_t titlesOffset;     ///< Offset of the titles
+    uint64_t blobsOffset;      ///< Offset of the first ROM blob
+    uint64_t fileSize;         ///< Total size, to detect truncated files
+    uint64_t reserved;
+};
+
+struct CorpusEntry {
+    uint64_t hash;        ///< XXH64 of the ROM
+    uint64_t blobOffset;  ///< Absolute offset of the ROM bytes
+    uint32_t size;        ///< ROM size in bytes
+    uint32_t titleOffset; ///< Offset of the title, from `titlesOffset`
+    uint16_t titleLength; ///< Title length in bytes
+    uint8_t  platform;    ///< Detected `RomPlatform`
+    uint8_t  quirks;      ///< Detected `RomQuirk` flags
+    uint32_t reserved;
+};
+
+static_assert(sizeof(CorpusHeader) == 64, "CorpusHeader must stay 64 bytes");
+static_assert(sizeof(CorpusEntry)  == 32, "CorpusEntry must stay 32 bytes");
+
+/// A ROM as stored in an open corpus. Pointers stay valid while the corpus is open.
+struct CorpusRom {
+    const CorpusEntry *entry; ///< Metadata
+    const uint8_t     *bytes; ///< ROM content
+    std::string        title; ///< ROM title
+};
+
+/// Read-only access to a `.c8pack` file
+class RomCorpus {
+    private: // Private fields
+        std::string         fileName;    ///< Opened file (for error messages)
+        const uint8_t      *mapping;     ///< Whole file
+        size_t              mappingSize; ///< Size of the mapping
+        const CorpusHeader *header;      ///< Header, inside the mapping
+        const CorpusEntry  *entries;     ///< Hash-sorted entries, inside the mapping
+        const uint32_t     *titleIndex;  ///< Title-sorted ids, inside the mapping
+        const char         *titles;      ///< Titles, inside the mapping
+
+    public:  // Public functions
+        explicit RomCorpus(const std::string &fileName);
+        ~RomCorpus();
+
+        RomCorpus(const RomCorpus &) = delete;
+        RomCorpus &operator=(const RomCorpus &) = delete;
+
+        size_t size() const;
+        CorpusRom at(size_t entryId) const;
+
+        bool find(uint64_t hash, CorpusRom &rom) const;
+        bool find(const std::string &title, CorpusRom &rom) const;
+        bool find_any(const std::string &titleOrHash, CorpusRom &rom) const;
+
+    private: // Private functions
+        std::string title_of(const CorpusEntry &entry) const;
+};
+
+/// Builds a corpus from every `.ch8` file under `directory`, scanned with `threadCount` workers
+size_t build_rom_corpus(const std::string &directory, const std::string &outputFileName, unsigned int threadCount);
+
+RomPlatform detect_rom_platform(const uint8_t *bytes, size_t size);
+uint8_t     detect_rom_quirks(const uint8_t *bytes, size_t size);
+const char *get_platform_name(RomPlatform platform);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Static recompiler : recovers the control flow of a CHIP-8 program and emits it as C++.
+ *
+ * Code is found by following every jump, call, skip and fall-through from 0x200. Each basic block
+ * becomes a native function over the core's state (see `RecompiledRuntime`) that runs exactly its
+ * instructions and leaves `pc` where the interpreter would. What can't be known ahead of time is
+ * left to the interpreter : targets of computed jumps (BNNN) and code modified at run time, which
+ * the core detects by comparing each block with the bytes it was generated from.
+ */
+class RomRecompiler {
+    private: // Private types
+        struct Block {
+            uint16_t              address;      ///< First instruction
+            std::vector<uint16_t> instructions; ///< Raw instructions, in order
+        };
+
+    private: // Private fields
+        std::vector<uint8_t>      program;       ///< Program bytes, as loaded at 0x200
+        std::array<uint8_t, 4096> reached;       ///< Per address : 1 when a supported instruction starts there
+        std::array<uint8_t, 4096> leaders;       ///< Per address : 1 when a block starts there
+        std::vector<Block>        blocks;        ///< Blocks, sorted by address
+        size_t                    computedJumps; ///< BNNN instructions found
+
+    public:  // Public functions
+        RomRecompiler(const uint8_t *program, size_t programSize);
+
+        void emit(std::ostream &output, const std::string &title) const;
+
+        // Getters
+        size_t get_block_count()         const;
+        size_t get_instruction_count()   const;
+        size_t get_computed_jump_count() const;
+
+    private: // Private functions
+        void explore();
+        void build_blocks();
+
+        bool     contains(uint32_t address) const;
+        uint16_t instruction_at(uint16_t address) const;
+
+        void emit_block(std::ostream &output, const Block &block) const;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+#include "glad/gl.h"
+
+/**
+ * Builds a vertex + fragment shader program in the current OpenGL context.
+ *
+ * Linked programs are cached on disk with `glGetProgramBinary()` under `$CHIP8PP_CACHE_DIR`
+ * (default `$XDG_CACHE_HOME/chip8pp` or `~/.cache/chip8pp`), keyed by the hash of the sources and
+ * of the driver's vendor, renderer and version strings, so later launches skip compilation. A
+ * missing, stale or rejected cache entry silently falls back to compiling the sources.
+ *
+ * Throws `std::runtime_error`, with the driver's info log, when compilation or linking fails.
+ */
+GLuint create_shader_program(const std::string &name, const std::string &vertexSource, const std::string &fragmentSource);
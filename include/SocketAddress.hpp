@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+#include <sys/socket.h>
+
+// Socket addresses given on the command line : `<scheme>:HOST:PORT` for IP (e.g. `udp:127.0.0.1:7000`,
+// `tcp:[::1]:9100`, an empty HOST binds every interface) or `unix:PATH` for Unix domain sockets.
+// `family` restricts the result (AF_UNSPEC : any). Errors are thrown as `std::runtime_error`.
+socklen_t resolve_socket_address(const std::string &address, const std::string &ipScheme, int socketType, int family,
+                                 struct sockaddr_storage &resolved);
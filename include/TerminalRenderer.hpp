@@ -0,0 +1,36 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "DisplayView.hpp"
+
+/**
+ * Renders the packed display on an ANSI terminal with Unicode half-blocks (two rows per cell).
+ *
+ * Only the cells that changed since the previous frame are emitted, with cursor jumps when the
+ * changed cells are not contiguous, and the whole frame goes out in a single `write()`.
+ */
+class TerminalRenderer {
+    private: // Private fields
+        int                      fileDescriptor; ///< Where frames are written
+        unsigned int             originRow;      ///< 1-based terminal row of the display's top-left cell
+        unsigned int             originColumn;   ///< 1-based terminal column of the display's top-left cell
+        std::array<uint64_t, 32> previousRows;   ///< Last frame sent to the terminal
+        bool                     fullRedraw;     ///< Whether the next frame must repaint every cell
+        std::string              frameBuffer;    ///< Reused escape-sequence buffer
+
+    public:  // Public functions
+        TerminalRenderer(int fileDescriptor = 1, unsigned int originRow = 1, unsigned int originColumn = 1);
+        ~TerminalRenderer();
+
+        size_t render(const DisplayView &view);
+        void   invalidate();
+
+        static std::string to_text(const DisplayView &view);
+
+    private: // Private functions
+        void move_cursor(unsigned int row, unsigned int column);
+        void flush();
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// One trace event, as recorded by the emulation thread. Strings are literals : nothing is copied
+struct TimelineEvent {
+    const char *name;       ///< Event name shown on the timeline
+    const char *category;   ///< `host` or `guest`
+    const char *argName;    ///< Name of the optional argument, NULL for none
+    int64_t     argValue;   ///< Value of the optional argument
+    uint64_t    startNs;    ///< `Timeline::now()` when the event began
+    uint64_t    durationNs; ///< Length of a complete event
+    char        phase;      ///< Trace-event phase : 'X' (complete) or 'i' (instant)
+};
+
+/// Events of one thread, in a ring it writes and the timeline writer drains
+struct TimelineBuffer {
+    static const size_t CAPACITY = 1 << 14; ///< Events (power of two); later ones are dropped until the writer catches up
+
+    std::array<TimelineEvent, CAPACITY> events;      ///< Ring storage
+    std::atomic<uint64_t>               head;        ///< Events written, only stored by the owning thread
+    std::atomic<uint64_t>               tail;        ///< Events drained, only stored by the writer
+    std::atomic<uint64_t>               dropped;     ///< Events lost to a full ring
+    unsigned int                        threadId;    ///< `tid` of the events in the trace
+    std::string                         threadName;  ///< Shown by the trace viewer, guarded by the `Timeline` mutex
+    bool                                nameWritten; ///< Whether `threadName` already went to the file
+};
+
+/**
+ * Trace-event timeline (the JSON format of `chrome://tracing` and Perfetto) of frames, emulation
+ * batches, draws, swaps, input and guest events.
+ *
+ * Recording is off until a `TimelineWriter` is created, and then costs a relaxed load per call site.
+ * While on, each thread appends fixed-size events to a preallocated ring of its own (no lock, no
+ * allocation, no formatting) and the writer thread turns them into JSON, early when a ring gets half
+ * full. Rings are handed out and reclaimed like the shards of `Metrics`.
+ */
+class Timeline {
+    private: // Private types
+        struct BufferLease;
+
+    private: // Private fields
+        static std::atomic<bool> recording; ///< Whether events are recorded
+
+        std::mutex                                   mutex;          ///< Guards both lists and the thread names
+        std::vector<std::unique_ptr<TimelineBuffer>> buffers;        ///< Every ring ever handed out
+        std::vector<TimelineBuffer *>                freeBuffers;    ///< Rings of threads that exited
+        std::mutex                                   wakeMutex;      ///< Waited on by the writer between drains
+        std::condition_variable                      drainRequested; ///< Notified when a ring is half full
+
+    public:  // Public functions
+        static Timeline &instance();
+        static uint64_t now();
+
+        /// Whether events are being recorded, to skip reading the clock when they aren't
+        static bool enabled() {
+            return Timeline::recording.load(std::memory_order_relaxed);
+        }
+
+        static void complete(const char *name, const char *category, uint64_t startNs, uint64_t endNs,
+                             const char *argName = NULL, int64_t argValue = 0);
+        static void instant(const char *name, const char *category, const char *argName = NULL, int64_t argValue = 0);
+        static void name_thread(const std::string &name);
+
+    private: // Private functions
+        Timeline();
+
+        static TimelineBuffer &local();
+        static void record(const TimelineEvent &event);
+
+        TimelineBuffer *acquire_buffer();
+        void release_buffer(TimelineBuffer *buffer);
+
+    friend class TimelineWriter;
+};
+
+/**
+ * Records the `Timeline` into a JSON file for its whole lifetime.
+ *
+ * A thread of its own drains the rings every few milliseconds, so formatting and disk writes stay
+ * off the emulation threads. The file is a complete trace once the writer is destroyed; events lost
+ * to full rings are counted in its metadata.
+ */
+class TimelineWriter {
+    private: // Private constants
+        static const int FLUSH_PERIOD_MS = 20; ///< Longest delay between two drains
+
+    private: // Private fields
+        std::ofstream     output;     ///< Trace file
+        uint64_t          originNs;   ///< `Timeline::now()` at creation, timestamp 0 of the trace
+        bool              firstEvent; ///< Whether no event was written yet (no separating comma)
+        uint64_t          written;    ///< Events written
+        std::atomic<bool> stopping;   ///< Set by the destructor
+        std::thread       thread;     ///< Drains the rings
+
+    public:  // Public functions
+        explicit TimelineWriter(const std::string &path);
+        ~TimelineWriter();
+
+        TimelineWriter(const TimelineWriter &) = delete;
+        TimelineWriter &operator=(const TimelineWriter &) = delete;
+
+    private: // Private functions
+        void drain_periodically();
+        uint64_t drain();
+        void write_event(const TimelineEvent &event, unsigned int threadId);
+        void write_thread_name(const TimelineBuffer &buffer);
+};
+
+/// Records its scope as a complete event, when the timeline is on
+class TimelineScope {
+    private: // Private fields
+        const char *name;     ///< Event name
+        const char *category; ///< Event category
+        uint64_t    startNs;  ///< 0 when the timeline was off at construction
+
+    public:  // Public functions
+        TimelineScope(const char *name, const char *category) : name(name), category(category), startNs(Timeline::enabled() ? Timeline::now() : 0) {}
+
+        ~TimelineScope() {
+            if (this->startNs != 0) {
+                Timeline::complete(this->name, this->category, this->startNs, Timeline::now());
+            }
+        }
+
+        TimelineScope(const TimelineScope &) = delete;
+        TimelineScope &operator=(const TimelineScope &) = delete;
+};
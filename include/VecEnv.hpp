@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Chip8.hpp"
+#include "WorkerPool.hpp"
+
+/**
+ * Batch of headless cores running the same ROM, for reinforcement learning.
+ *
+ * Every environment is stepped by whole emulated frames with one CHIP-8 key held (actions 0-15,
+ * anything else holds no key). Observations are written as `size() x 32 x 64` bytes, one per
+ * pixel (0 or 1), into a buffer owned by the caller; nothing is allocated per step. Environments
+ * are spread across a `WorkerPool`.
+ *
+ * An episode ends when the program halts (jump to itself), hits an unsupported instruction or
+ * reaches `maxEpisodeFrames`. The environment is then reset right away with the next seed of its
+ * sequence (`seed + 1`), and the observation returned is the first one of the new episode.
+ */
+class VecEnv {
+    public: // Public constants
+        static const size_t  OBSERVATION_SIZE = DisplayView::HEIGHT * DisplayView::WIDTH; ///< Bytes per environment in an observation buffer
+        static const uint8_t NO_KEY           = 0xFF; ///< Action holding no key
+
+    private: // Private fields
+        std::unique_ptr<Chip8>              initial;          ///< Core with the program loaded, forked on every reset
+        std::vector<std::unique_ptr<Chip8>> cores;            ///< One headless core per environment
+        std::vector<uint32_t>               seeds;            ///< Seed of each environment's current episode
+        std::vector<uint64_t>               episodeFrames;    ///< Frames run in each environment's current episode
+        std::vector<uint8_t>                scores;           ///< Score byte at the end of the previous step
+        WorkerPool                          pool;             ///< Steps the environments
+        unsigned int                        frameCycles;      ///< Instructions per emulated frame
+        uint64_t                            maxEpisodeFrames; ///< Frames before an episode is cut (0 : never)
+        int                                 scoreAddress;     ///< RAM address holding the score (-1 : no rewards)
+
+    public:  // Public functions
+        VecEnv(const std::string &romPath, size_t envCount, unsigned int threadCount = 0);
+
+        void reset(const uint32_t *seeds, uint8_t *observations);
+        void step(const uint8_t *actions, unsigned int framesPerStep, uint8_t *observations, float *rewards, uint8_t *dones);
+
+        // Setters
+        void set_frame_cycles(unsigned int frameCycles);
+        void set_max_episode_frames(uint64_t maxEpisodeFrames);
+        void set_score_address(int scoreAddress);
+
+        // Getters
+        size_t       size()             const;
+        unsigned int get_thread_count() const;
+
+    private: // Private functions
+        void reset_env(size_t envId, uint32_t seed);
+        void write_observation(size_t envId, uint8_t *observations) const;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of threads running batches of independent tasks.
+ *
+ * `run()` hands tasks `0 .. taskCount-1` out one at a time to the workers and to the calling
+ * thread, then returns once all of them are done. Threads are kept between batches, so a batch
+ * only costs a wake-up. The first exception thrown by a task is rethrown by `run()`.
+ */
+class WorkerPool {
+    public: // Public types
+        typedef std::function<void(size_t taskId)> Task;
+
+    private: // Private fields
+        std::vector<std::thread> workers;      ///< Helper threads (the caller of `run()` works too)
+        std::mutex               mutex;        ///< Guards everything below but `nextTask`
+        std::condition_variable  wake;         ///< Signaled when a batch starts or on shutdown
+        std::condition_variable  done;         ///< Signaled when the last worker leaves a batch
+        const Task              *task;         ///< Task of the current batch
+        size_t                   taskCount;    ///< Tasks in the current batch
+        std::atomic<size_t>      nextTask;     ///< Next task to hand out
+        size_t                   busyWorkers;  ///< Workers still in the current batch
+        uint64_t                 batch;        ///< Incremented on every `run()`
+        bool                     stopping;     ///< Set by the destructor
+        std::exception_ptr       firstError;   ///< First exception thrown in the current batch
+
+    public:  // Public functions
+        explicit WorkerPool(unsigned int threadCount = 0);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool &operator=(const WorkerPool &) = delete;
+
+        void run(size_t taskCount, const Task &task);
+
+        // Getters
+        unsigned int get_thread_count() const;
+
+    private: // Private functions
+        void work();
+        void drain();
+};
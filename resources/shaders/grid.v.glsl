@@ -2,9 +2,20 @@
 
 layout(location = 0) in vec2 position;
 
-uniform mat4 model;
+// Packed display : two words per row (left half first), most significant bit is the leftmost pixel
+layout(std430, binding = 0) readonly buffer DisplayState {
+    uint displayWords[64];
+};
+
 uniform mat4 projection;
 
 void main() {
-    gl_Position = projection * model * vec4(position, 0.0, 1.0);
+    int x = gl_InstanceID % 64; // One instance per pixel
+    int y = gl_InstanceID / 64;
+
+    uint word    = displayWords[2*y + x/32];
+    bool enabled = ((word >> uint(31 - x%32)) & 1u) != 0u;
+
+    // Disabled pixels are moved out of the clip volume, so they're never rasterized
+    gl_Position = enabled ? projection * vec4(position + vec2(x, y), 0.0, 1.0) : vec4(2.0, 2.0, 2.0, 1.0);
 }
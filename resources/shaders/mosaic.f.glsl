@@ -0,0 +1,25 @@
+#version 440
+
+// Packed displays, 64 words per instance : two words per row (left half first), most significant bit is the leftmost pixel
+layout(std430, binding = 0) readonly buffer MosaicState {
+    uint displayWords[];
+};
+
+uniform vec4 enabledColor;
+
+in vec2 displayPosition;
+flat in int instance;
+
+out vec4 fragColor;
+
+void main() {
+    int x = min(int(displayPosition.x), 63);
+    int y = min(int(displayPosition.y), 31);
+
+    uint word = displayWords[64*instance + 2*y + x/32];
+    if (((word >> uint(31 - x%32)) & 1u) == 0u) {
+        discard;
+    }
+
+    fragColor = enabledColor;
+}
@@ -0,0 +1,17 @@
+#version 440
+
+layout(location = 0) in vec2 position; // Unit square
+
+uniform ivec2 mosaicSize; // Columns and rows of tiles
+
+out vec2 displayPosition; // Position inside the tile, in emulated pixels
+flat out int instance;
+
+void main() {
+    vec2 tile      = vec2(gl_InstanceID % mosaicSize.x, gl_InstanceID / mosaicSize.x); // One instance per tile
+    vec2 placement = (tile + position) / vec2(mosaicSize);                             // 0-1, top-left origin
+
+    instance        = gl_InstanceID;
+    displayPosition = position * vec2(64.0, 32.0);
+    gl_Position     = vec4(placement.x * 2.0 - 1.0, 1.0 - placement.y * 2.0, 0.0, 1.0);
+}
@@ -0,0 +1,120 @@
+#include "AsyncReadback.hpp"
+
+#include <stdexcept>
+
+AsyncReadback::AsyncReadback(unsigned int width, unsigned int height, const Consumer &consumer, size_t ringSize)
+    : width(width), height(height), frameSize(static_cast<size_t>(width) * height * 4), consumer(consumer),
+      slots(ringSize < 1 ? 1 : ringSize), oldest(0), inFlight(0), stalls(0) {
+
+    const GLbitfield mappingFlags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    for (size_t slotId = 0; slotId < this->slots.size(); ++slotId) {
+        Slot &slot = this->slots[slotId];
+
+        glGenBuffers(1, &slot.bufferAddress);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.bufferAddress);
+        glBufferStorage(GL_PIXEL_PACK_BUFFER, this->frameSize, NULL, mappingFlags);
+
+        slot.mapping = static_cast<const uint8_t *>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, this->frameSize, mappingFlags));
+        slot.fence   = NULL;
+        slot.frameId = 0;
+
+        if (slot.mapping == NULL) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            glDeleteBuffers(1, &slot.bufferAddress);
+            this->release_slots(slotId); // The destructor won't run
+            throw std::runtime_error("OpenGL error : Failed to map a readback buffer");
+        }
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+AsyncReadback::~AsyncReadback() {
+    this->release_slots(this->slots.size());
+}
+
+/// Unmaps and deletes the buffers of the first `count` slots, with their pending fences
+void AsyncReadback::release_slots(size_t count) {
+    for (size_t slotId = 0; slotId < count; ++slotId) {
+        Slot &slot = this->slots[slotId];
+
+        if (slot.fence != NULL) {
+            glDeleteSync(slot.fence);
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.bufferAddress);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glDeleteBuffers(1, &slot.bufferAddress);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+/// Queues the readback of the bound read framebuffer. Only waits when every buffer is still in flight.
+void AsyncReadback::capture(uint64_t frameId) {
+    this->poll();
+
+    if (this->inFlight == this->slots.size()) {
+        ++this->stalls;
+        this->consume_oldest(true);
+    }
+
+    Slot &slot = this->slots[(this->oldest + this->inFlight) % this->slots.size()];
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.bufferAddress);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, this->width, this->height, GL_RGBA, GL_UNSIGNED_BYTE, NULL); // Into the buffer, returns immediately
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence   = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frameId = frameId;
+    ++this->inFlight;
+
+    glFlush(); // Makes sure the fence is submitted, so polling can see it signaled
+}
+
+/// Hands every finished frame to the consumer, without waiting. Returns how many were consumed.
+size_t AsyncReadback::poll() {
+    size_t consumed = 0;
+    while (this->inFlight > 0 && this->consume_oldest(false)) {
+        ++consumed;
+    }
+    return consumed;
+}
+
+/// Waits for and consumes every queued frame
+void AsyncReadback::flush() {
+    while (this->inFlight > 0) {
+        this->consume_oldest(true);
+    }
+}
+
+uint64_t AsyncReadback::get_stall_count() const {
+    return this->stalls;
+}
+
+bool AsyncReadback::consume_oldest(bool wait) {
+    Slot &slot = this->slots[this->oldest];
+
+    GLenum status = glClientWaitSync(slot.fence, 0, 0);
+    while (wait && status == GL_TIMEOUT_EXPIRED) {
+        status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000); // 1s per try
+    }
+
+    if (status == GL_TIMEOUT_EXPIRED) {
+        return false;
+    }
+    if (status == GL_WAIT_FAILED) {
+        throw std::runtime_error("OpenGL error : Waiting for a readback fence failed");
+    }
+
+    glDeleteSync(slot.fence);
+    slot.fence = NULL;
+
+    this->consumer(slot.mapping, this->frameSize, slot.frameId);
+
+    this->oldest = (this->oldest + 1) % this->slots.size();
+    --this->inFlight;
+    return true;
+}
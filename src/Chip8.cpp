@@ -1,14 +1,84 @@
 #include "Chip8.hpp"
-
+#include "Hash.hpp"
+#include "LatencyHistogram.hpp"
+#include "Metrics.hpp"
+#include "RomCache.hpp"
+#include "TerminalRenderer.hpp"
+#include "Timeline.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <csignal>
+#include <cstdio>
 #include <exception>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <streambuf>
+#include <unordered_map>
+#include <vector>
 #include <cmath>
+#include <cstring>
 #include <random>
 
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
+// Per-instruction logging. Compiled out when CHIP8PP_NO_TRACE is defined (e.g. benchmarks).
+#ifdef CHIP8PP_NO_TRACE
+    #define CHIP8_TRACE(message) ((void)0)
+#else
+    #define CHIP8_TRACE(message) (std::cout << message)
+#endif
+
+namespace {
+    // Phases of an iteration of `Chip8::run()`, each timed into its own histogram
+    enum FramePhase {
+        PHASE_INPUT,   ///< glfwPollEvents()
+        PHASE_EMULATE, ///< Batch of emulated frames
+        PHASE_UPLOAD,  ///< Render submission
+        PHASE_SWAP,    ///< glfwSwapBuffers()
+        PHASE_COUNT
+    };
+
+    const char *const PHASE_NAMES[PHASE_COUNT] = {"input", "emulate", "upload", "swap"};
+
+    volatile std::sig_atomic_t phaseReportRequested = 0; ///< Set by SIGUSR1, polled by `Chip8::run()`
+
+    void request_phase_report(int) {
+        phaseReportRequested = 1;
+    }
+
+    void print_phase_report(std::ostream &output, const std::string &name, const std::array<LatencyHistogram, PHASE_COUNT> &phases) {
+        output << "PHASES (" << name << ") :\n";
+
+        char line[160];
+        for (size_t phase = 0; phase < PHASE_COUNT; ++phase) {
+            const LatencyHistogram &histogram = phases[phase];
+            std::snprintf(line, sizeof(line), "  %-8s %8llu samples, p50 %9.1f us, p99 %9.1f us, p99.9 %9.1f us, max %9.1f us\n",
+                          PHASE_NAMES[phase], (unsigned long long)histogram.get_count(), histogram.get_percentile(50) * 1e-3,
+                          histogram.get_percentile(99) * 1e-3, histogram.get_percentile(99.9) * 1e-3, histogram.get_max() * 1e-3);
+            output << line;
+        }
+    }
+
+    const uint16_t FONT_ADDRESS = 0x050; // Built-in font : 16 glyphs of 5 bytes
+    const uint8_t  FONT[80]     = {
+        0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
+        0x20, 0x60, 0x20, 0x20, 0x70, // 1
+        0xF0, 0x10, 0xF0, 0x80, 0xF0, // 2
+        0xF0, 0x10, 0xF0, 0x10, 0xF0, // 3
+        0x90, 0x90, 0xF0, 0x10, 0x10, // 4
+        0xF0, 0x80, 0xF0, 0x10, 0xF0, // 5
+        0xF0, 0x80, 0xF0, 0x90, 0xF0, // 6
+        0xF0, 0x10, 0x20, 0x40, 0x40, // 7
+        0xF0, 0x90, 0xF0, 0x90, 0xF0, // 8
+        0xF0, 0x90, 0xF0, 0x10, 0xF0, // 9
+        0xF0, 0x90, 0xF0, 0x90, 0x90, // A
+        0xE0, 0x90, 0xE0, 0x90, 0xE0, // B
+        0xF0, 0x80, 0x80, 0x80, 0xF0, // C
+        0xE0, 0x90, 0x90, 0x90, 0xE0, // D
+        0xF0, 0x80, 0xF0, 0x80, 0xF0, // E
+        0xF0, 0x80, 0xF0, 0x80, 0x80  // F
+    };
+}
 
 
 bool init_emu() {
@@ -119,13 +189,128 @@ std::string get_hex_representation(uint original) {
 }
 
 
-Chip8::Chip8(const std::string &name) : name(name),        pc(0),
-                                        indexRegister(0),  addressStack(),
-                                        delayTimer(60),    soundTimer(60),
-                                        opcode(0),         firstRegister(0),
-                                        secondRegister(0), spriteSize(0),
-                                        immediateValue(0), immediateAddress(0),
-                                        randomEngine(),    randomDistribution(0, 255) {
+std::string disassemble(uint16_t instruction) {
+    unsigned int x   = (instruction & 0x0F00) >> 8;
+    unsigned int y   = (instruction & 0x00F0) >> 4;
+    unsigned int n   =  instruction & 0x000F;
+    unsigned int nn  =  instruction & 0x00FF;
+    unsigned int nnn =  instruction & 0x0FFF;
+
+    char text[32];
+
+    switch (instruction >> 12) {
+        case 0x0:
+            if (instruction == 0x00E0) {
+                return "CLS";
+            } else if (instruction == 0x00EE) {
+                return "RET";
+            }
+            std::snprintf(text, sizeof(text), "SYS 0x%03X", nnn);
+            break;
+
+        case 0x1: std::snprintf(text, sizeof(text), "JP 0x%03X", nnn);             break;
+        case 0x2: std::snprintf(text, sizeof(text), "CALL 0x%03X", nnn);           break;
+        case 0x3: std::snprintf(text, sizeof(text), "SE V%X, 0x%02X", x, nn);      break;
+        case 0x4: std::snprintf(text, sizeof(text), "SNE V%X, 0x%02X", x, nn);     break;
+        case 0x5: std::snprintf(text, sizeof(text), "SE V%X, V%X", x, y);          break;
+        case 0x6: std::snprintf(text, sizeof(text), "LD V%X, 0x%02X", x, nn);      break;
+        case 0x7: std::snprintf(text, sizeof(text), "ADD V%X, 0x%02X", x, nn);     break;
+
+        case 0x8: {
+            static const char *const ALU_MNEMONICS[16] = {"LD", "OR", "AND", "XOR", "ADD", "SUB", "SHR", "SUBN",
+                                                          NULL, NULL, NULL,  NULL,  NULL,  NULL,  "SHL", NULL};
+            if (ALU_MNEMONICS[n] == NULL) {
+                std::snprintf(text, sizeof(text), "DW 0x%04X", instruction);
+            } else {
+                std::snprintf(text, sizeof(text), "%s V%X, V%X", ALU_MNEMONICS[n], x, y);
+            }
+            break;
+        }
+
+        case 0x9: std::snprintf(text, sizeof(text), "SNE V%X, V%X", x, y);         break;
+        case 0xA: std::snprintf(text, sizeof(text), "LD I, 0x%03X", nnn);          break;
+        case 0xB: std::snprintf(text, sizeof(text), "JP V0, 0x%03X", nnn);         break;
+        case 0xC: std::snprintf(text, sizeof(text), "RND V%X, 0x%02X", x, nn);     break;
+        case 0xD: std::snprintf(text, sizeof(text), "DRW V%X, V%X, %u", x, y, n);  break;
+
+        case 0xE:
+            if (nn == 0x9E) {
+                std::snprintf(text, sizeof(text), "SKP V%X", x);
+            } else if (nn == 0xA1) {
+                std::snprintf(text, sizeof(text), "SKNP V%X", x);
+            } else {
+                std::snprintf(text, sizeof(text), "DW 0x%04X", instruction);
+            }
+            break;
+
+        default:
+        case 0xF:
+            switch (nn) {
+                case 0x07: std::snprintf(text, sizeof(text), "LD V%X, DT", x);   break;
+                case 0x0A: std::snprintf(text, sizeof(text), "LD V%X, K", x);    break;
+                case 0x15: std::snprintf(text, sizeof(text), "LD DT, V%X", x);   break;
+                case 0x18: std::snprintf(text, sizeof(text), "LD ST, V%X", x);   break;
+                case 0x1E: std::snprintf(text, sizeof(text), "ADD I, V%X", x);   break;
+                case 0x29: std::snprintf(text, sizeof(text), "LD F, V%X", x);    break;
+                case 0x33: std::snprintf(text, sizeof(text), "LD B, V%X", x);    break;
+                case 0x55: std::snprintf(text, sizeof(text), "LD [I], V%X", x);  break;
+                case 0x65: std::snprintf(text, sizeof(text), "LD V%X, [I]", x);  break;
+                default:   std::snprintf(text, sizeof(text), "DW 0x%04X", instruction); break;
+            }
+            break;
+    }
+
+    return text;
+}
+
+
+Chip8::Chip8(const std::string &name, bool headless) : name(name),
+                                                       randomEngine(std::make_shared<std::mt19937>()),
+                                                       randomDistribution(0, 255),
+                                                       pc(0),             indexRegister(0),
+                                                       addressStack(),    stackSize(0),
+                                                       delayTimer(60),    soundTimer(60),
+                                                       display(NULL),     keypadState(0),
+                                                       displayGeneration(0),
+                                                       frameHash(0),      frameHashGeneration(~0ULL),
+                                                       instructionCount(0), collapsedCycles(0),
+                                                       reportedInstructions(0), reportedCollapsed(0),
+                                                       pendingDrawOps(0), pendingFrames(0), keyWaitStart(0),
+                                                       recompiled(NULL),
+                                                       opcode(0),         firstRegister(0),
+                                                       secondRegister(0), spriteSize(0),
+                                                       immediateValue(0), immediateAddress(0),
+                                                       pacer(),           sleeper(),
+                                                       swapInterval(1),   frameCycles(11),
+                                                       drawnGeneration(0), redrawRequested(true) {
+    // Initializing groups
+    this->pages.fill(Chip8::zero_page()); // Copied on first write
+    this->pages[0] = Chip8::font_page();
+    this->codePage   = this->pages[0].get();
+    this->codePageId = 0;
+    this->variableRegisters.fill(0);
+    this->addressStack.fill(0);
+    this->displayState.fill(0);
+
+#ifdef CHIP8PP_PROFILE
+    this->fusionEnabled = false; // The guest profile counts every instruction on its own
+#else
+    this->fusionEnabled = true;
+#endif
+
+    Metrics::add(Metrics::local().coresCreated, 1);
+
+#ifdef CHIP8PP_PROFILE
+    this->pcCounts.fill(0);
+    this->opcodeCounts.fill(0);
+    this->drawTimer.calls = this->drawTimer.ticks = 0;
+    this->keyTimer.calls  = this->keyTimer.ticks  = 0;
+#endif
+
+    if (headless) {
+        return; // No window nor OpenGL context : the core is driven through `step()`
+    }
+
     // GLFW window preparation
     this->display = glfwCreateWindow(800, 400, "pico8", NULL, NULL);
     std::cout << "IF 0 CHECK IF EMU IS INIT'D : " << this->display << std::endl;
@@ -138,352 +323,541 @@ Chip8::Chip8(const std::string &name) : name(name),        pc(0),
     glfwSetKeyCallback(this->display, Chip8::glfw_key_callback);
     glfwSetErrorCallback(Chip8::glfw_error_callback);
 
-    // Prepare OpenGL renderer
+    this->renderer.reset(new GridRenderer());
+}
 
-    float squareVertices[] = {1.0f, 1.0f,    1.0f,  0.0f,    0.0f,  0.0f,    0.0f, 1.0f};
-    //float squareVertices[] = {0.0f, 0.5f,    0.0f,  -0.5f,    -1.0f,  -0.5f,    -1.0f, 0.5f};
-    //float squareVertices[] = {0.5f, 0.5f,    0.5f, -0.5f,   -0.5f, -0.5f,   -0.5f, 0.5f};
-    unsigned int squareIndices[] = {0, 1, 3,    1, 2, 3};
-    
-    GLuint vboAddress;
-    GLuint eboAddress;
+/// Headless copy of `parent` sharing its RAM pages and random engine (see `fork()`)
+Chip8::Chip8(const Chip8 &parent) : name(parent.name),
+                                    pages(parent.pages),
+                                    variableRegisters(parent.variableRegisters),
+                                    codePage(parent.codePage),
+                                    codePageId(parent.codePageId),
+                                    randomEngine(parent.randomEngine),
+                                    randomDistribution(parent.randomDistribution),
+                                    pc(parent.pc),
+                                    indexRegister(parent.indexRegister),
+                                    addressStack(parent.addressStack),
+                                    stackSize(parent.stackSize),
+                                    delayTimer(parent.delayTimer),
+                                    soundTimer(parent.soundTimer),
+                                    display(NULL),
+                                    keypadState(parent.keypadState),
+                                    displayState(parent.displayState),
+                                    displayGeneration(parent.displayGeneration),
+                                    frameHash(parent.frameHash),
+                                    frameHashGeneration(parent.frameHashGeneration),
+                                    rawInstruction(parent.rawInstruction),
+                                    instructionCount(parent.instructionCount),
+                                    collapsedCycles(parent.collapsedCycles),
+                                    reportedInstructions(parent.instructionCount), // The parent reports its own
+                                    reportedCollapsed(parent.collapsedCycles),
+                                    pendingDrawOps(0),
+                                    pendingFrames(0),
+                                    keyWaitStart(0),
+                                    fusionEnabled(parent.fusionEnabled),
+                                    recompiled(parent.recompiled),
+                                    opcode(parent.opcode),
+                                    firstRegister(parent.firstRegister),
+                                    secondRegister(parent.secondRegister),
+                                    spriteSize(parent.spriteSize),
+                                    immediateValue(parent.immediateValue),
+                                    immediateAddress(parent.immediateAddress),
+                                    renderer(),
+                                    pacer(parent.pacer),
+                                    sleeper(),
+                                    swapInterval(parent.swapInterval),
+                                    frameCycles(parent.frameCycles),
+                                    drawnGeneration(0),
+                                    redrawRequested(true) {
+#ifdef CHIP8PP_PROFILE
+    this->pcCounts     = parent.pcCounts;
+    this->opcodeCounts = parent.opcodeCounts;
+    this->drawTimer    = parent.drawTimer;
+    this->keyTimer     = parent.keyTimer;
+#endif
+
+    Metrics::add(Metrics::local().coresCreated, 1);
+}
 
-    glGenBuffers(1, &vboAddress);
-    glGenBuffers(1, &eboAddress);
-    glGenVertexArrays(1, &this->vaoAddress);
+Chip8::~Chip8() {
+    this->report_metrics();
+    Metrics::add(Metrics::local().coresDestroyed, 1);
+}
 
-    glBindVertexArray(vaoAddress);
-    glBindBuffer(GL_ARRAY_BUFFER,         vboAddress);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboAddress);
+/**
+ * Independent headless copy of the core, e.g. to branch a search tree. RAM pages and the random
+ * engine stay shared with the original until either side writes to them, so a fork costs the
+ * registers, the display and the pages it later modifies. Forks have no window : their keys are
+ * set with `set_keypad_state()`. Several threads may fork the same core as long as none runs it.
+ */
+std::unique_ptr<Chip8> Chip8::fork() const {
+    return std::unique_ptr<Chip8>(new Chip8(*this));
+}
 
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(squareIndices), squareIndices, GL_STATIC_DRAW);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(squareVertices), squareVertices, GL_STATIC_DRAW);
+/// 60Hz timers, decremented once per emulated frame : by `run_frames()`, or by callers cutting frames with `run_cycles()`
+void Chip8::tick_timers() {
+    if (this->delayTimer > 0) {
+        --this->delayTimer;
+    }
+    if (this->soundTimer > 0) {
+        --this->soundTimer;
+    }
+}
 
-    glEnableVertexAttribArray(0); // Vertices
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2*sizeof(float), (void*)0);
+/// Memory of a core right after loading a program : what repeat loads of the same `RomImage` install
+struct LoadedProgram {
+    std::array<std::shared_ptr<Chip8::MemoryPage>, Chip8::PAGE_COUNT> pages;      ///< Pooled pages, fused table included
+    const RecompiledRom                                               *recompiled; ///< Native code of the program, if any
+};
 
-    this->pixelColor = glm::vec4(1.0, 1.0, 1.0, 1.0);
+void Chip8::load_program(const std::string &fileName) {
+    RomCache                            &cache   = RomCache::instance();
+    std::shared_ptr<const RomImage>      program = cache.load(fileName); // Only hits the disk once per file
+    std::shared_ptr<const LoadedProgram> loaded  = cache.get_loaded_program(*program);
+
+    // Only a core still on its initial pages ends up with exactly the cached memory
+    bool pristine = this->pages[0] == Chip8::font_page();
+    for (unsigned int pageId = 1; pageId < PAGE_COUNT && pristine; ++pageId) {
+        pristine = this->pages[pageId] == Chip8::zero_page();
+    }
 
-    GLuint vShaderAddress, fShaderAddress;
-    vShaderAddress = glCreateShader(GL_VERTEX_SHADER);
-    fShaderAddress = glCreateShader(GL_FRAGMENT_SHADER);
+    if (loaded && pristine) {
+        this->pages      = loaded->pages; // Page pointers only : writes copy them first
+        this->codePage   = this->pages[this->codePageId].get();
+        this->recompiled = loaded->recompiled;
+        this->pc         = 512;
+        return;
+    }
 
-    std::ifstream vShaderFile("resources/shaders/grid.v.glsl");
-    std::ifstream fShaderFile("resources/shaders/grid.f.glsl");
+    this->load_program(program->bytes.data(), program->bytes.size());
 
-    std::string vShaderSourceCode((std::istreambuf_iterator<char>(vShaderFile)), std::istreambuf_iterator<char>());
-    std::string fShaderSourceCode((std::istreambuf_iterator<char>(fShaderFile)), std::istreambuf_iterator<char>());
+    if (pristine) {
+        std::shared_ptr<LoadedProgram> built = std::make_shared<LoadedProgram>();
+        built->pages      = this->pages;
+        built->recompiled = this->recompiled;
 
-    vShaderFile.close();
-    fShaderFile.close();
+        cache.set_loaded_program(*program, built);
+    }
+}
 
-    const char *vShaderSourceRaw = vShaderSourceCode.c_str();
-    const char *fShaderSourceRaw = fShaderSourceCode.c_str();
+void Chip8::load_program(const uint8_t *program, size_t programSize) {
+    if (programSize > 4096-512) {
+        throw std::runtime_error("Program is too big to fit in the memory (" + std::to_string(programSize) + " bytes)");
+    }
+
+    for (size_t byteId = 0; byteId < programSize; ++byteId) {
+        this->write(static_cast<uint16_t>(512 + byteId), program[byteId]);
+    }
+    this->recompiled = RecompiledRomRegistry::instance().find(program, programSize);
+    this->refresh_fused_ops(0, 4095);
+    this->share_pages(); // Cores running the same program end up on the same pages
+
+    this->pc = 512;
+}
 
-    const int vShaderSourceSize = static_cast<int>(vShaderSourceCode.length());
-    const int fShaderSourceSize = static_cast<int>(fShaderSourceCode.length());
+void Chip8::run() {
+    glfwSwapInterval(this->swapInterval); // Explicit, rather than whatever the driver defaults to
 
-    glShaderSource(vShaderAddress, 1, &vShaderSourceRaw, &vShaderSourceSize);
-    glShaderSource(fShaderAddress, 1, &fShaderSourceRaw, &fShaderSourceSize);
+    this->pacer.reset(DeadlineSleeper::now());
 
-    glCompileShader(vShaderAddress);
+    MetricsShard &metrics     = Metrics::local();
+    double        lastPresent = -1;
 
-    GLint vSuccess = 0;
-    glGetShaderiv(vShaderAddress, GL_COMPILE_STATUS, &vSuccess);
+    std::array<LatencyHistogram, PHASE_COUNT> phases;
 
-    if (vSuccess == GL_FALSE) {
-        GLint logSize = 0;
-        glGetShaderiv(vShaderAddress, GL_INFO_LOG_LENGTH, &logSize);
-        
-        GLchar *log;
-        glGetShaderInfoLog(vShaderAddress, logSize, NULL, log);
+    struct sigaction reportAction;
+    std::memset(&reportAction, 0, sizeof(reportAction));
+    reportAction.sa_handler = request_phase_report;
+    reportAction.sa_flags   = SA_RESTART;
+    sigaction(SIGUSR1, &reportAction, NULL); // `kill -USR1` prints the phase report without stopping
 
-        std::cout << "SHADER ERROR: ";
-        for (size_t c=0; c < logSize; ++c) {
-            std::cout << log[c];
+    while (!glfwWindowShouldClose(this->display)) {
+        uint64_t frameStart = Timeline::now();
+        glfwPollEvents();
+        uint64_t phaseStart = Timeline::now();
+        phases[PHASE_INPUT].record(phaseStart - frameStart);
+        Timeline::complete("input", "host", frameStart, phaseStart);
+
+        double       now       = DeadlineSleeper::now();
+        double       deadline  = this->pacer.get_next_frame_time();
+        unsigned int framesDue = this->pacer.frames_due(now);
+
+        if (framesDue > 0) {
+            Metrics::observe(metrics.emulationLag, now - deadline);
         }
-        std::cout << std::endl;
 
-        throw std::runtime_error("OpenGL vertex shader exception");
+        // Emulated frames run at the target refresh whatever the host does; only the last one is drawn
+        if (framesDue > 0) {
+            phaseStart = Timeline::now();
+            this->run_frames(framesDue);
+            uint64_t emulated = Timeline::now();
+            phases[PHASE_EMULATE].record(emulated - phaseStart);
+            Timeline::complete("emulate", "host", phaseStart, emulated, "frames", framesDue);
+        }
+
+        // An idle ROM leaves the display alone : the previous frame stays on screen, no draw nor swap
+        if (framesDue > 0 && (this->displayGeneration != this->drawnGeneration || this->redrawRequested)) {
+            phaseStart = Timeline::now();
+            this->renderer->draw(this->get_display_view());
+            uint64_t uploaded = Timeline::now();
+            glfwSwapBuffers(this->display);
+            uint64_t swapped = Timeline::now();
+
+            phases[PHASE_UPLOAD].record(uploaded - phaseStart);
+            phases[PHASE_SWAP].record(swapped - uploaded);
+            Timeline::complete("draw", "host", phaseStart, uploaded);
+            Timeline::complete("swap", "host", uploaded, swapped);
+
+            this->drawnGeneration = this->displayGeneration;
+            this->redrawRequested = false;
+
+            double presented = DeadlineSleeper::now();
+            if (lastPresent >= 0) {
+                Metrics::observe(metrics.frameTime, presented - lastPresent);
+            }
+            lastPresent = presented;
+            Metrics::add(metrics.renderedFrames, 1);
+            this->pacer.frame_presented();
+
+            CHIP8_TRACE(std::flush);
+        }
+
+        if (phaseReportRequested) {
+            phaseReportRequested = 0;
+            print_phase_report(std::cerr, this->name, phases);
+        }
+
+        phaseStart = Timeline::now();
+        this->sleeper.sleep_until(this->pacer.get_next_frame_time());
+        uint64_t frameEnd = Timeline::now();
+        Timeline::complete("sleep", "host", phaseStart, frameEnd);
+        Timeline::complete("frame", "host", frameStart, frameEnd); // One iteration : the budget of a host frame
     }
 
-    glCompileShader(fShaderAddress);
+    std::cerr << "PACING (" << this->name << ") : " << this->pacer.get_emulated_frames() << " emulated frames, "
+              << this->pacer.get_rendered_frames() << " rendered, " << this->pacer.get_skipped_frames() << " skipped, "
+              << this->pacer.get_dropped_frames() << " dropped\n";
+    this->sleeper.print_report(std::cerr);
+    print_phase_report(std::cerr, this->name, phases);
+}
 
-    GLint fSuccess = 0;
-    glGetShaderiv(fShaderAddress, GL_COMPILE_STATUS, &fSuccess);
+void Chip8::step() {
+    CHIP8_PROFILE_COUNT(this->pcCounts, this->pc & 0xFFF);
 
-    if (fSuccess == GL_FALSE) {
-        GLint logSize = 0;
-        glGetShaderiv(fShaderAddress, GL_INFO_LOG_LENGTH, &logSize);
-        
-        GLchar *log;
-        glGetShaderInfoLog(fShaderAddress, logSize, NULL, log);
+    this->fetch();
+    this->decode();
+
+    CHIP8_PROFILE_COUNT(this->opcodeCounts, this->opcode);
+
+    this->execute();
+    ++this->instructionCount;
+}
 
-        std::cout << "SHADER ERROR: ";
-        for (size_t c=0; c < logSize; ++c) {
-            std::cout << log[c];
+/**
+ * Executes exactly `cycles` instructions, running the fused sequences of the side table in one go.
+ * A sequence is only fused when all of its instructions fit in the remaining budget, so callers
+ * stopping on a given cycle (end of frame, checkpoint) see the same state as with `step()`.
+ */
+void Chip8::run_cycles(uint64_t cycles) {
+    this->execute_cycles(cycles);
+    this->report_metrics();
+}
+
+/// Body of `run_cycles()`, leaving the metrics to the caller
+void Chip8::execute_cycles(uint64_t cycles) {
+    static const uint64_t FUSED_LENGTHS[] = {1, 1, 2, 2, 3, 3, 1}; ///< Most instructions per fused sequence, by `FusedOp`
+
+    while (cycles > 0) {
+        FusedOp fusedOp = FusedOp::NONE;
+        if (this->fusionEnabled && this->pc < PAGE_SIZE * PAGE_COUNT) {
+            fusedOp = this->code_page().fusedOps[this->pc % PAGE_SIZE];
         }
-        std::cout << std::endl;
 
-        throw std::runtime_error("OpenGL fragment shader exception");
-    }
+        if (cycles < FUSED_LENGTHS[static_cast<size_t>(fusedOp)]) {
+            fusedOp = FusedOp::NONE; // The sequence would cross the stop cycle
+        }
 
-    this->programAddress = glCreateProgram();
+        uint64_t executed = 1;
+        switch (fusedOp) {
+            case FusedOp::IDLE_JUMP:
+                executed = this->fused_idle_jump(cycles);
+                break;
 
-    glAttachShader(this->programAddress, vShaderAddress);
-    glAttachShader(this->programAddress, fShaderAddress);
+            case FusedOp::SET_ADD:
+                executed = this->fused_set_add();
+                break;
 
-    glLinkProgram(this->programAddress);
+            case FusedOp::INDEX_DRAW:
+                executed = this->fused_index_draw();
+                break;
 
-    GLint pSuccess = 0;
-    glGetProgramiv(this->programAddress, GL_LINK_STATUS, &pSuccess);
+            case FusedOp::DELAY_WAIT:
+                executed = this->fused_delay_wait(cycles);
+                break;
 
-    if (pSuccess == GL_FALSE) {
-        GLint logSize = 0;
-        glGetProgramiv(this->programAddress, GL_INFO_LOG_LENGTH, &logSize);
+            case FusedOp::INDEX_LOAD:
+                executed = this->fused_index_load();
+                break;
 
-        GLchar *log;
-        glGetShaderInfoLog(this->programAddress, logSize, NULL, log);
+            case FusedOp::NATIVE:
+                executed = this->recompiled->dispatch(*this, this->pc, cycles);
+                if (executed > 0) {
+                    break;
+                }
+                // Block longer than the budget : interprets its first instruction instead
+                this->step();
+                cycles -= 1;
+                continue;
 
-        std::cout << "SHADER LINK ERROR: ";
-        for (size_t c=0; c < logSize; ++c) {
-            std::cout << log[c];
+            default:
+                this->step();
+                cycles -= 1;
+                continue;
         }
-        std::cout << std::endl;
 
-        throw std::runtime_error("OpenGL Shader program failed to link");
+        this->instructionCount += executed;
+        cycles                 -= executed;
     }
+}
 
-    glDeleteShader(vShaderAddress);
-    glDeleteShader(fShaderAddress);
+/// Runs `frames` emulated frames : `frameCycles` instructions then a timer tick each
+void Chip8::run_frames(unsigned int frames) {
+    for (unsigned int frame = 0; frame < frames; ++frame) {
+        this->execute_cycles(this->frameCycles);
+        this->tick_timers();
+        ++this->pendingFrames;
+    }
 
-    glUseProgram(this->programAddress);
+    this->report_metrics();
+}
 
-    this->enabledColorUniformLocation     = glGetUniformLocation(this->programAddress, "enabledColor");
-    this->modelMatrixUniformLocation      = glGetUniformLocation(this->programAddress, "model");
-    this->projectionMatrixUniformLocation = glGetUniformLocation(this->programAddress, "projection");
+void Chip8::set_swap_interval(int swapInterval) {
+    this->swapInterval = swapInterval;
+}
 
-    glUniform4fv(this->enabledColorUniformLocation, 1, glm::value_ptr(this->pixelColor)); // Sending opaque white to the shader
-    
-    glBindVertexArray(0); // Unbinding VAO first
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+void Chip8::set_refresh_rate(double refreshRate) {
+    this->pacer.set_refresh_rate(refreshRate);
+}
 
-    // Initializing groups
-    this->ram.fill(0);
-    this->variableRegisters.fill(0);
-    
-    for (std::array<bool, 32> *col = this->displayState.begin(); col != this->displayState.end(); ++col) {
-        col->fill(0);
-    }
-
-    // Inserting a built-in font in the ram
-    this->ram[0x050] = 0xF0;
-    this->ram[0x051] = 0x90;
-    this->ram[0x052] = 0x90;
-    this->ram[0x053] = 0x90;
-    this->ram[0x054] = 0xF0, // 0
-
-    this->ram[0x055] = 0x20;
-    this->ram[0x056] = 0x60;
-    this->ram[0x057] = 0x20;
-    this->ram[0x058] = 0x20;
-    this->ram[0x059] = 0x70; // 1
-
-    this->ram[0x05A] = 0xF0;
-    this->ram[0x05B] = 0x10;
-    this->ram[0x05C] = 0xF0;
-    this->ram[0x05D] = 0x80;
-    this->ram[0x05E] = 0xF0; // 2
-
-    this->ram[0x05F] = 0xF0;
-    this->ram[0x060] = 0x10;
-    this->ram[0x061] = 0xF0;
-    this->ram[0x062] = 0x10;
-    this->ram[0x063] = 0xF0; // 3
-
-    this->ram[0x064] = 0x90;
-    this->ram[0x065] = 0x90;
-    this->ram[0x066] = 0xF0;
-    this->ram[0x067] = 0x10;
-    this->ram[0x068] = 0x10; // 4
-
-    this->ram[0x069] = 0xF0;
-    this->ram[0x06A] = 0x80;
-    this->ram[0x06B] = 0xF0;
-    this->ram[0x06C] = 0x10;
-    this->ram[0x06D] = 0xF0;// 5
-
-    this->ram[0x06E] = 0xF0;
-    this->ram[0x06F] = 0x80;
-    this->ram[0x070] = 0xF0;
-    this->ram[0x071] = 0x90;
-    this->ram[0x072] = 0xF0; // 6
-
-    this->ram[0x073] = 0xF0;
-    this->ram[0x074] = 0x10;
-    this->ram[0x075] = 0x20;
-    this->ram[0x076] = 0x40;
-    this->ram[0x077] = 0x40; // 7
-
-    this->ram[0x078] = 0xF0;
-    this->ram[0x079] = 0x90;
-    this->ram[0x07A] = 0xF0;
-    this->ram[0x07B] = 0x90;
-    this->ram[0x07C] = 0xF0; // 8
-
-    this->ram[0x07D] = 0xF0;
-    this->ram[0x07E] = 0x90;
-    this->ram[0x07F] = 0xF0;
-    this->ram[0x080] = 0x10;
-    this->ram[0x081] = 0xF0, // 9
-
-    this->ram[0x082] = 0xF0;
-    this->ram[0x083] = 0x90;
-    this->ram[0x084] = 0xF0;
-    this->ram[0x085] = 0x90;
-    this->ram[0x086] = 0x90, // A
-
-    this->ram[0x087] = 0xE0;
-    this->ram[0x088] = 0x90;
-    this->ram[0x089] = 0xE0;
-    this->ram[0x08A] = 0x90;
-    this->ram[0x08B] = 0xE0; // B
-
-    this->ram[0x08C] = 0xF0;
-    this->ram[0x08D] = 0x80;
-    this->ram[0x08E] = 0x80;
-    this->ram[0x08F] = 0x80;
-    this->ram[0x090] = 0xF0; // C
-
-    this->ram[0x091] = 0xE0;
-    this->ram[0x092] = 0x90;
-    this->ram[0x093] = 0x90;
-    this->ram[0x094] = 0x90;
-    this->ram[0x095] = 0xE0; // D
-
-    this->ram[0x096] = 0xF0;
-    this->ram[0x097] = 0x80;
-    this->ram[0x098] = 0xF0;
-    this->ram[0x099] = 0x80;
-    this->ram[0x09A] = 0xF0; // E
-    
-    this->ram[0x09B] = 0xF0;
-    this->ram[0x09C] = 0x80;
-    this->ram[0x09D] = 0xF0;
-    this->ram[0x09E] = 0x80;
-    this->ram[0x09F] = 0x80;  // F
+void Chip8::set_frame_cycles(unsigned int frameCycles) {
+    this->frameCycles = frameCycles;
 }
 
-void Chip8::load_program(const std::string &fileName) {
-    std::ifstream programFile(fileName, std::ios::binary|std::ios::ate);
-    if (!programFile.is_open()) {
-        throw std::runtime_error("Program file not found : `" + fileName + "`");
-    }
+void Chip8::set_fusion_enabled(bool fusionEnabled) {
+    this->fusionEnabled = fusionEnabled;
+}
 
-    std::streampos programSize = programFile.tellg();
-    
-    if (programSize > 4096-512) {
-        throw std::runtime_error("Program is too big to fit in the memory (" + std::to_string(programSize) + " bytes)");
+void Chip8::set_keypad_state(uint16_t keypadState) {
+    uint16_t changedKeys = this->keypadState ^ keypadState;
+    if (changedKeys != 0) {
+        Metrics::add(Metrics::local().keyEvents, std::bitset<16>(changedKeys).count()); // One press or release per key
+        Timeline::instant("keypad", "host", "state", keypadState);
     }
-    
-    char *program = new char[programSize];
 
-    programFile.seekg(0, std::ios::beg);
-    programFile.read(program, programSize);
-    programFile.close();
+    this->keypadState = keypadState;
+}
 
-    for (uint16_t programByteId = 0; programByteId < programSize; ++programByteId) {
-        this->ram[512 + programByteId] = static_cast<uint8_t>(program[programByteId]);
-    }
+void Chip8::set_random_seed(uint32_t seed) {
+    this->randomEngine = std::make_shared<std::mt19937>(seed); // Leaves the engine of other forks alone
+    this->randomDistribution.reset();
+}
 
-    this->pc = 512;
+DisplayView Chip8::get_display_view() const {
+    DisplayView view = {this->displayState.data(), 1, this->displayGeneration};
+    return view;
 }
 
-void Chip8::run() {
-    double maxChipFrequency = 0;
+uint64_t Chip8::get_display_generation() const {
+    return this->displayGeneration;
+}
 
-    double elapsedChipTime = 0;
-    while (!glfwWindowShouldClose(this->display)) {
-        elapsedChipTime -= glfwGetTime();
+uint64_t Chip8::get_instruction_count() const {
+    return this->instructionCount;
+}
 
-        glfwSwapBuffers(this->display);
-        glfwPollEvents();
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-        
-        glm::mat4 projectionMatrix = glm::ortho(0.0f, 64.0f, 32.0f, 0.0f, -1.0f, 1.0f);
+uint64_t Chip8::get_collapsed_cycles() const {
+    return this->collapsedCycles;
+}
 
-        glBindVertexArray(this->vaoAddress);
-        glUseProgram(this->programAddress);
+const RecompiledRom *Chip8::get_recompiled_rom() const {
+    return this->recompiled;
+}
 
-        glUniformMatrix4fv(this->projectionMatrixUniformLocation, 1, GL_FALSE, glm::value_ptr(projectionMatrix));
+uint8_t Chip8::get_memory_byte(uint16_t address) const {
+    return this->read(address);
+}
 
-        // Updating render
-        for (int i=0; i < 64; ++i) {
-            for (int j=0; j < 32; ++j) {
-                if (this->displayState[i][j]) {
-                    glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3((float)i, (float)j, 0.0f));
-                    glUniformMatrix4fv(this->modelMatrixUniformLocation, 1, GL_FALSE, glm::value_ptr(modelMatrix));
+/// Whether the program is stuck on a jump to itself (how most ROMs end)
+bool Chip8::is_halted() const {
+    return this->pc < PAGE_SIZE * PAGE_COUNT && this->get_fused_op(this->pc) == FusedOp::IDLE_JUMP;
+}
 
-                    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-                }
-            }
-        }
+uint64_t Chip8::get_frame_hash() {
+    if (this->frameHashGeneration != this->displayGeneration) { // Only rehash when a CLS or DXYN touched the display since last time
+        this->frameHash           = xxhash64_words(this->displayState.data(), this->displayState.size());
+        this->frameHashGeneration = this->displayGeneration;
+    }
+
+    return this->frameHash;
+}
+
+/// Hash of the whole guest state (RAM, registers, stack, timers, display) to compare two runs; the random engine is left out
+uint64_t Chip8::get_state_hash() const {
+    uint8_t registers[16 + 2*2 + 3 + 2*STACK_SIZE] = {0}; // V0-VF, pc, I, timers, stack size, stack (little-endian)
+    std::copy(this->variableRegisters.begin(), this->variableRegisters.end(), registers);
+    registers[16] = static_cast<uint8_t>(this->pc);
+    registers[17] = static_cast<uint8_t>(this->pc >> 8);
+    registers[18] = static_cast<uint8_t>(this->indexRegister);
+    registers[19] = static_cast<uint8_t>(this->indexRegister >> 8);
+    registers[20] = this->delayTimer;
+    registers[21] = this->soundTimer;
+    registers[22] = this->stackSize;
+    for (uint8_t depth = 0; depth < this->stackSize; ++depth) {
+        registers[23 + 2*depth] = static_cast<uint8_t>(this->addressStack[depth]);
+        registers[24 + 2*depth] = static_cast<uint8_t>(this->addressStack[depth] >> 8);
+    }
 
-        glBindVertexArray(0);
-        glUseProgram(0);
+    uint64_t hash = xxhash64_words(this->displayState.data(), this->displayState.size());
+    hash = xxhash64(registers, sizeof(registers), hash);
+    for (unsigned int pageId = 0; pageId < PAGE_COUNT; ++pageId) {
+        hash = xxhash64(this->pages[pageId]->bytes.data(), PAGE_SIZE, hash);
+    }
+    return hash;
+}
 
-        if (elapsedChipTime > 0) {
-            continue; // Skip chip tick if running too fast. Can most likely be improved.
+void Chip8::print_profile_report(std::ostream &output, size_t hotspotCount) const {
+#ifdef CHIP8PP_PROFILE
+    static const char *const OPCODE_CLASSES[16] = {"00E0/00EE/0NNN", "1NNN JP",   "2NNN CALL", "3XNN SE",
+                                                   "4XNN SNE",       "5XY0 SE",   "6XNN LD",   "7XNN ADD",
+                                                   "8XYN ALU",       "9XY0 SNE",  "ANNN LD I", "BNNN JP V0",
+                                                   "CXNN RND",       "DXYN DRW",  "EX__ keys", "FX__ misc"};
+
+    uint64_t total = 0;
+    std::vector<uint16_t> hotspots;
+    for (uint16_t address = 0; address < this->pcCounts.size(); ++address) {
+        if (this->pcCounts[address] > 0) {
+            total += this->pcCounts[address];
+            hotspots.push_back(address);
         }
+    }
 
-        elapsedChipTime = maxChipFrequency;
+    std::sort(hotspots.begin(), hotspots.end(), [this](uint16_t left, uint16_t right) {
+        return this->pcCounts[left] > this->pcCounts[right];
+    });
 
-        this->fetch();
-        this->decode();
-        this->execute();
+    char line[96];
+    output << "PROFILE (" << this->name << ") : " << total << " instructions\n\nHOTSPOTS :\n";
 
-        std::cout << std::flush;
+    for (size_t rank = 0; rank < hotspots.size() && rank < hotspotCount; ++rank) {
+        uint16_t address     = hotspots[rank];
+        uint16_t instruction = static_cast<uint16_t>(this->read(address) << 8 | this->read(address+1));
+
+        std::snprintf(line, sizeof(line), "  0x%03X  %12llu  %5.1f%%  %04X  %s\n", address,
+                      (unsigned long long)this->pcCounts[address], 100.0 * this->pcCounts[address] / total,
+                      instruction, disassemble(instruction).c_str());
+        output << line;
     }
-}
 
-std::array<std::array<bool, 32>, 64> Chip8::get_display_state() {
-    return this->displayState;
-}
+    output << "\nOPCODE CLASSES :\n";
+    for (size_t opcodeClass = 0; opcodeClass < this->opcodeCounts.size(); ++opcodeClass) {
+        if (this->opcodeCounts[opcodeClass] == 0) {
+            continue;
+        }
 
-GLint Chip8::get_model_matrix_uniform_location() const {
-    return this->modelMatrixUniformLocation;
+        std::snprintf(line, sizeof(line), "  %-15s %12llu  %5.1f%%\n", OPCODE_CLASSES[opcodeClass],
+                      (unsigned long long)this->opcodeCounts[opcodeClass], 100.0 * this->opcodeCounts[opcodeClass] / total);
+        output << line;
+    }
+
+    output << "\nTIMED OPERATIONS (ticks) :\n";
+    const ProfileTimer *timers[2]     = {&this->drawTimer, &this->keyTimer};
+    const char         *timerNames[2] = {"DXYN", "EX9E/EXA1/FX0A"};
+
+    for (size_t timerId = 0; timerId < 2; ++timerId) {
+        const ProfileTimer &timer = *timers[timerId];
+        std::snprintf(line, sizeof(line), "  %-15s %12llu calls  %14llu total  %10.1f avg\n", timerNames[timerId],
+                      (unsigned long long)timer.calls, (unsigned long long)timer.ticks,
+                      timer.calls ? static_cast<double>(timer.ticks) / timer.calls : 0.0);
+        output << line;
+    }
+#else
+    (void)hotspotCount;
+    output << "PROFILE (" << this->name << ") : profiling is disabled, rebuild with -DCHIP8PP_PROFILE=ON\n";
+#endif
 }
 
 GLint Chip8::get_projection_matrix_uniform_location() const {
-    return this->projectionMatrixUniformLocation;
+    return this->renderer->get_projection_matrix_uniform_location();
 }
 
 GLint Chip8::get_enabled_color_uniform_location() const {
-    return this->enabledColorUniformLocation;
+    return this->renderer->get_enabled_color_uniform_location();
 }
 
 GLint Chip8::get_program_address() const {
-    return this->programAddress;
+    return this->renderer->get_program_address();
 }
 
-char Chip8::read(const uint16_t &address) {
-    return this->ram[address];
+inline uint8_t Chip8::read(uint16_t address) const {
+    return this->pages[address / PAGE_SIZE % PAGE_COUNT]->bytes[address % PAGE_SIZE];
 }
 
-void Chip8::write(const uint16_t &address, const uint8_t &value) {
-    this->ram[address] = value;
+/// Stores a byte without reclassifying the fused sequences around it (callers refresh the range they wrote)
+void Chip8::write(uint16_t address, uint8_t value) {
+    this->writable_page(address).bytes[address % PAGE_SIZE] = value;
 }
 
-void Chip8::fetch() {
-    this->rawInstruction = 0; // Reset next raw instruction
+/// Page holding `address`, copied first if another core (or the shared zero page) still uses it
+Chip8::MemoryPage &Chip8::writable_page(uint16_t address) {
+    uint16_t                     pageId = address / PAGE_SIZE % PAGE_COUNT;
+    std::shared_ptr<MemoryPage> &page   = this->pages[pageId];
+
+    if (page.use_count() != 1) {
+        page = std::make_shared<MemoryPage>(*page);
+        if (pageId == this->codePageId) {
+            this->codePage = page.get();
+        }
+    }
+    return *page;
+}
+
+/// Page holding `pc`, cached since most instructions run from the page of the previous one
+inline const Chip8::MemoryPage &Chip8::code_page() {
+    uint16_t pageId = this->pc / PAGE_SIZE % PAGE_COUNT;
+    if (pageId != this->codePageId) {
+        this->codePage   = this->pages[pageId].get();
+        this->codePageId = pageId;
+    }
+    return *this->codePage;
+}
+
+int Chip8::poll_key(int glfwKey) {
+    if (this->display == NULL) { // Headless cores have no keyboard : keys are set with `set_keypad_state()`
+        static const int KEYBOARD[16] = {GLFW_KEY_X, GLFW_KEY_1, GLFW_KEY_2, GLFW_KEY_3, GLFW_KEY_Q, GLFW_KEY_W, GLFW_KEY_E, GLFW_KEY_A,
+                                         GLFW_KEY_S, GLFW_KEY_D, GLFW_KEY_Z, GLFW_KEY_C, GLFW_KEY_4, GLFW_KEY_R, GLFW_KEY_F, GLFW_KEY_V};
+
+        for (int key = 0; key < 16; ++key) {
+            if (KEYBOARD[key] == glfwKey) {
+                return (this->keypadState >> key) & 1 ? GLFW_PRESS : GLFW_RELEASE;
+            }
+        }
+        return GLFW_RELEASE;
+    }
 
-    // Causes segfault.
-    this->rawInstruction |= static_cast<uint16_t>(this->ram[this->pc]) << 8;
-    this->rawInstruction |= this->ram[this->pc+1]; // Offsetting program counter to next byte
+    return glfwGetKey(this->display, glfwKey);
+}
 
-    std::cout << "TRACK: Fetched raw instruction 0x" << get_bin_representation(this->rawInstruction) << "\n";
+/// Inline, like `code_page()` and `read()`, as every instruction goes through here
+inline void Chip8::fetch() {
+    uint16_t offset = this->pc % PAGE_SIZE;
+    if (offset + 1u < PAGE_SIZE) {
+        const MemoryPage &page = this->code_page();
+        this->rawInstruction   = static_cast<uint16_t>(page.bytes[offset] << 8 | page.bytes[offset+1]);
+    } else { // Instruction straddling two pages
+        this->rawInstruction = static_cast<uint16_t>(this->read(this->pc) << 8 | this->read(this->pc+1));
+    }
+
+    CHIP8_TRACE("TRACK: Fetched raw instruction 0x" << get_bin_representation(this->rawInstruction) << "\n");
 }
 
 void Chip8::decode() {
@@ -499,7 +873,7 @@ void Chip8::decode() {
 }
 
 void Chip8::execute() {
-    std::cout << "TRACK: opcode : " << get_hex_representation(this->opcode) << "\n";
+    CHIP8_TRACE("TRACK: opcode : " << get_hex_representation(this->opcode) << "\n");
     switch(this->opcode) {
         case 0x0:
             switch(this->rawInstruction) { // Whole instruction have fixed shape for most `0___` instructions
@@ -605,19 +979,25 @@ void Chip8::execute() {
             this->random();
             break;
 
-        case 0xD:
+        case 0xD: {
+            CHIP8_PROFILE_SCOPE(this->drawTimer);
             this->draw();
             break;
+        }
         
         case 0xE:
             switch(this->immediateValue) { // Last 8 bits differentiate `E_XX` opcodes
-                case 0x9E:
+                case 0x9E: {
+                    CHIP8_PROFILE_SCOPE(this->keyTimer);
                     this->skip_if_key();
                     break;
+                }
                 
-                case 0xA1:
+                case 0xA1: {
+                    CHIP8_PROFILE_SCOPE(this->keyTimer);
                     this->skip_if_not_key();
                     break;
+                }
                 
                 default:
                     throw std::runtime_error("Unimplemented opcode starting by `E` : `" + std::to_string(this->opcode) + "`");
@@ -631,9 +1011,11 @@ void Chip8::execute() {
                     this->set_reg_to_delay_timer();
                     break;
 
-                case 0x0A:
+                case 0x0A: {
+                    CHIP8_PROFILE_SCOPE(this->keyTimer);
                     this->get_key();
                     break;
+                }
 
                 case 0x15:
                     this->set_delay_timer_to_reg();
@@ -675,36 +1057,36 @@ void Chip8::execute() {
 }
 
 void Chip8::execute_machine_routine() {
-    std::cout << "SKIPPING MACHINE ROUTINE EXECUTION\n";
+    CHIP8_TRACE("SKIPPING MACHINE ROUTINE EXECUTION\n");
 }
 
 void Chip8::clear_screen() {
-    for (std::array<bool, 32> *col = this->displayState.begin(); col != this->displayState.end(); ++col) {
-        col->fill(0);
-    }
+    Timeline::instant("CLS", "guest");
+
+    this->displayState.fill(0);
+    ++this->displayGeneration;
 
     this->pc += 2;
 
-    std::cout << "TRACK: Cleared screen\n";
+    CHIP8_TRACE("TRACK: Cleared screen\n");
 }
 
 void Chip8::jump() {
     this->pc = this->immediateAddress;
 
-    std::cout << "TRACK: jumped to " << (int)this->immediateAddress << "\n";
+    CHIP8_TRACE("TRACK: jumped to " << (int)this->immediateAddress << "\n");
 }
 
 void Chip8::call_subroutine() {
-    this->addressStack.push(this->pc);
-    std::cout << "TRACK: Called a subroutine (pushed `" << this->pc << "` to the stack.)\n";
+    this->push_address(this->pc);
+    CHIP8_TRACE("TRACK: Called a subroutine (pushed `" << this->pc << "` to the stack.)\n");
     this->pc = this->immediateAddress;
 }
 
 void Chip8::exit_subroutine() {
-    std::cout << std::flush;
-    this->pc = this->addressStack.top();
-    this->addressStack.pop();
-    std::cout << "TRACK: Exited a subroutine (Popped `" << this->pc << "` from the stack.)\n";
+    CHIP8_TRACE(std::flush);
+    this->pc = this->pop_address();
+    CHIP8_TRACE("TRACK: Exited a subroutine (Popped `" << this->pc << "` from the stack.)\n");
 
     this->pc += 2;
 }
@@ -712,40 +1094,40 @@ void Chip8::exit_subroutine() {
 void Chip8::skip_if_value() {
     if (this->variableRegisters[this->firstRegister] == this->immediateValue) {
         this->pc += 4;
-        std::cout << "TRACK: Skipped to `" << this->pc << "` because register " << (int)this->firstRegister << " is equal to immediate value `" << (int)this->immediateValue << "`\n";
+        CHIP8_TRACE("TRACK: Skipped to `" << this->pc << "` because register " << (int)this->firstRegister << " is equal to immediate value `" << (int)this->immediateValue << "`\n");
     } else {
         this->pc += 2;
-        std::cout << "TRACK: Didn't skip because register " << (int)this->firstRegister << " is different from value `" << (int)this->immediateValue << "`\n";
+        CHIP8_TRACE("TRACK: Didn't skip because register " << (int)this->firstRegister << " is different from value `" << (int)this->immediateValue << "`\n");
     }
 }
 
 void Chip8::skip_if_not_value() {
     if (this->variableRegisters[this->firstRegister] != this->immediateValue) {
         this->pc += 4;
-        std::cout << "TRACK: Skipped to `" << this->pc << "` because register " << (int)this->firstRegister << " is different from immediate value `" << (int)this->immediateValue << "`\n";
+        CHIP8_TRACE("TRACK: Skipped to `" << this->pc << "` because register " << (int)this->firstRegister << " is different from immediate value `" << (int)this->immediateValue << "`\n");
     } else {
         this->pc += 2;
-        std::cout << "TRACK: Didn't skip because register " << (int)this->firstRegister << " is equal to value `" << (int)this->immediateValue << "`\n";
+        CHIP8_TRACE("TRACK: Didn't skip because register " << (int)this->firstRegister << " is equal to value `" << (int)this->immediateValue << "`\n");
     }
 }
 
 void Chip8::skip_if_equals_register() {
     if (this->variableRegisters[this->firstRegister] == this->variableRegisters[this->secondRegister]) {
         this->pc += 4;
-        std::cout << "TRACK: Skipped to `" << this->pc << "` because register " << (int)this->firstRegister << " is equal to register " << (int)this->secondRegister << "\n";
+        CHIP8_TRACE("TRACK: Skipped to `" << this->pc << "` because register " << (int)this->firstRegister << " is equal to register " << (int)this->secondRegister << "\n");
     } else {
         this->pc += 2;
-        std::cout << "TRACK: Didn't skip because register " << (int)this->firstRegister << "is different from register " << (int)this->secondRegister << "\n";
+        CHIP8_TRACE("TRACK: Didn't skip because register " << (int)this->firstRegister << "is different from register " << (int)this->secondRegister << "\n");
     }
 }
 
 void Chip8::skip_if_not_equals_register() {
     if (this->variableRegisters[this->firstRegister] != this->variableRegisters[this->secondRegister]) {
         this->pc += 4;
-        std::cout << "TRACK: Skipped to `" << this->pc << "` because register " << (int)this->firstRegister << " is different from register " << (int)this->secondRegister << "\n";
+        CHIP8_TRACE("TRACK: Skipped to `" << this->pc << "` because register " << (int)this->firstRegister << " is different from register " << (int)this->secondRegister << "\n");
     } else {
         this->pc += 2;
-        std::cout << "TRACK: Didn't skip because register " << (int)this->firstRegister << "is equal to register " << (int)this->secondRegister << "\n";
+        CHIP8_TRACE("TRACK: Didn't skip because register " << (int)this->firstRegister << "is equal to register " << (int)this->secondRegister << "\n");
     }
 }
 
@@ -754,7 +1136,7 @@ void Chip8::set_var_register() {
 
     this->pc += 2;
 
-    std::cout << "TRACK: Set " << (int)this->firstRegister << "th var register to " << (int)this->immediateValue << "\n";
+    CHIP8_TRACE("TRACK: Set " << (int)this->firstRegister << "th var register to " << (int)this->immediateValue << "\n");
 }
 
 void Chip8::add_var_register() {
@@ -762,35 +1144,35 @@ void Chip8::add_var_register() {
 
     this->pc += 2;
 
-    std::cout << "TRACK: Added " << (int)this->immediateValue << " to " << (int)this->firstRegister << "th var register\n";
+    CHIP8_TRACE("TRACK: Added " << (int)this->immediateValue << " to " << (int)this->firstRegister << "th var register\n");
 }
 
 void Chip8::set_from_other_register() {
     this->variableRegisters[this->firstRegister] = this->variableRegisters[this->secondRegister];
     this->pc += 2;
 
-    std::cout << "TRACK: Set " << (int)this->firstRegister << "th register to " << (int)this->secondRegister << "th's value (`" << (int)this->variableRegisters[this->firstRegister] << "`)\n";
+    CHIP8_TRACE("TRACK: Set " << (int)this->firstRegister << "th register to " << (int)this->secondRegister << "th's value (`" << (int)this->variableRegisters[this->firstRegister] << "`)\n");
 }
 
 void Chip8::bin_or() {
     this->variableRegisters[this->firstRegister] |= this->variableRegisters[this->secondRegister];
     this->pc += 2;
 
-    std::cout << "TRACK: Set " << (int)this->firstRegister << "th register to it's value |OR|" << (int)this->secondRegister << "th's one (`" << (int)this->variableRegisters[this->firstRegister] << "`)\n";
+    CHIP8_TRACE("TRACK: Set " << (int)this->firstRegister << "th register to it's value |OR|" << (int)this->secondRegister << "th's one (`" << (int)this->variableRegisters[this->firstRegister] << "`)\n");
 }
 
 void Chip8::bin_and() {
     this->variableRegisters[this->firstRegister] &= this->variableRegisters[this->secondRegister];
     this->pc += 2;
 
-    std::cout << "TRACK: Set " << (int)this->firstRegister << "th register to it's value &AND&" << (int)this->secondRegister << "th's one (`" << (int)this->variableRegisters[this->firstRegister] << "`)\n";
+    CHIP8_TRACE("TRACK: Set " << (int)this->firstRegister << "th register to it's value &AND&" << (int)this->secondRegister << "th's one (`" << (int)this->variableRegisters[this->firstRegister] << "`)\n");
 }
 
 void Chip8::bin_xor() {
     this->variableRegisters[this->firstRegister] ^= this->variableRegisters[this->secondRegister];
     this->pc += 2;
 
-    std::cout << "TRACK: Set " << (int)this->firstRegister << "th register to it's value ^XOR^ " << (int)this->secondRegister << "th's one (`" << (int)this->variableRegisters[this->firstRegister] << "`)\n";
+    CHIP8_TRACE("TRACK: Set " << (int)this->firstRegister << "th register to it's value ^XOR^ " << (int)this->secondRegister << "th's one (`" << (int)this->variableRegisters[this->firstRegister] << "`)\n");
 }
 
 void Chip8::add_from_other_register() {
@@ -805,7 +1187,7 @@ void Chip8::add_from_other_register() {
     this->variableRegisters[this->firstRegister] = static_cast<uint8_t>(additionResult);
     this->pc += 2;
 
-    std::cout << "TRACK: Set " << (int)this->firstRegister << "th register to it's value +PLUS+ " << (int)this->secondRegister << "th's one (`" << (int)this->variableRegisters[this->firstRegister] << "`)\n";
+    CHIP8_TRACE("TRACK: Set " << (int)this->firstRegister << "th register to it's value +PLUS+ " << (int)this->secondRegister << "th's one (`" << (int)this->variableRegisters[this->firstRegister] << "`)\n");
 }
 
 void Chip8::substract() {
@@ -818,7 +1200,7 @@ void Chip8::substract() {
     this->variableRegisters[this->firstRegister] -= this->variableRegisters[this->secondRegister];
     this->pc += 2;
 
-    std::cout << "TRACK: Set " << (int)this->firstRegister << "th register to it's value -MINUS- " << (int)this->secondRegister << "th's one (`" << (int)this->variableRegisters[this->firstRegister] << "`)\n";
+    CHIP8_TRACE("TRACK: Set " << (int)this->firstRegister << "th register to it's value -MINUS- " << (int)this->secondRegister << "th's one (`" << (int)this->variableRegisters[this->firstRegister] << "`)\n");
 }
 
 void Chip8::substract_reverse() {
@@ -831,7 +1213,7 @@ void Chip8::substract_reverse() {
     this->variableRegisters[this->firstRegister] = this->variableRegisters[this->secondRegister] - this->variableRegisters[this->firstRegister];
     this->pc += 2;
 
-    std::cout << "TRACK: Set " << (int)this->firstRegister << "th register to " << (int)this->secondRegister << "th register's value -MINUS- it's own one (`" << (int)this->variableRegisters[this->firstRegister] << "`)\n";
+    CHIP8_TRACE("TRACK: Set " << (int)this->firstRegister << "th register to " << (int)this->secondRegister << "th register's value -MINUS- it's own one (`" << (int)this->variableRegisters[this->firstRegister] << "`)\n");
 }
 
 void Chip8::bin_shift_left() {
@@ -839,7 +1221,7 @@ void Chip8::bin_shift_left() {
     this->variableRegisters[this->firstRegister] = (this->variableRegisters[this->secondRegister]) << 1;
     this->pc += 2;
 
-    std::cout << "TRACK: Left-shifted " << (int)this->firstRegister << "th register. Saved result (`" << this->variableRegisters[this->firstRegister] << "`) to " << this->secondRegister << "th register.";
+    CHIP8_TRACE("TRACK: Left-shifted " << (int)this->firstRegister << "th register. Saved result (`" << this->variableRegisters[this->firstRegister] << "`) to " << this->secondRegister << "th register.");
 }
 
 void Chip8::bin_shift_right() {
@@ -847,7 +1229,7 @@ void Chip8::bin_shift_right() {
     this->variableRegisters[this->firstRegister] = (this->variableRegisters[this->secondRegister]) >> 1;
     this->pc += 2;
 
-    std::cout << "TRACK: Right-shifted " << (int)this->firstRegister << "th register. Saved result (`" << this->variableRegisters[this->firstRegister] << "`) to " << this->secondRegister << "th register.";
+    CHIP8_TRACE("TRACK: Right-shifted " << (int)this->firstRegister << "th register. Saved result (`" << this->variableRegisters[this->firstRegister] << "`) to " << this->secondRegister << "th register.");
 }
 
 void Chip8::set_index_register() {
@@ -855,23 +1237,29 @@ void Chip8::set_index_register() {
 
     this->pc += 2;
     
-    std::cout << "TRACK: Set index register to " << (int)this->immediateAddress << "\n";
+    CHIP8_TRACE("TRACK: Set index register to " << (int)this->immediateAddress << "\n");
 }
 
 void Chip8::jump_with_offset() {
     this->pc = immediateAddress + this->variableRegisters[0];
 
-    std::cout << "TRACK: Jumped to `" << this->immediateAddress << " + " << this->variableRegisters[0] << "` (`" << this->pc << "`\n)";
+    CHIP8_TRACE("TRACK: Jumped to `" << this->immediateAddress << " + " << this->variableRegisters[0] << "` (`" << this->pc << "`\n)");
 }
 
 void Chip8::random() {
-    this->variableRegisters[this->firstRegister] = static_cast<uint8_t>(this->randomDistribution(this->randomEngine)) & this->immediateValue;
+    if (this->randomEngine.use_count() != 1) { // Forks draw their own numbers from the shared state onwards
+        this->randomEngine = std::make_shared<std::mt19937>(*this->randomEngine);
+    }
+
+    this->variableRegisters[this->firstRegister] = static_cast<uint8_t>(this->randomDistribution(*this->randomEngine)) & this->immediateValue;
     this->pc += 2;
 
-    std::cout << "TRACK: Put random value `" << (int)this->variableRegisters[this->firstRegister] << "` in " << (int)this->firstRegister << "th register\n";
+    CHIP8_TRACE("TRACK: Put random value `" << (int)this->variableRegisters[this->firstRegister] << "` in " << (int)this->firstRegister << "th register\n");
 }
 
 void Chip8::draw() {
+    TimelineScope timelineScope("DXYN", "guest");
+
     uint8_t xCoord = this->variableRegisters[this->firstRegister] %64;
     uint8_t yCoord = this->variableRegisters[this->secondRegister]%32;
 
@@ -882,156 +1270,139 @@ void Chip8::draw() {
             break;
         }
 
-        uint8_t rowData = this->ram[this->indexRegister+rowId];
-
-        /*
-         * 0 - 0b00000001
-         * 1 - 0b00000010
-         * 2 - 0b00000100
-         * 3 - 0b00001000
-         * 4 - 0b00010000
-         * 5 - 0b00100000
-         * 6 - 0b01000000
-         * 7 - 0b10000000
-         */
-        for (uint8_t pixelRank = 7; pixelRank < 255; pixelRank--) {
-            uint8_t xOffset = 7-pixelRank;
-            std::cout << "DEBUG: pixel rank : " << (int)pixelRank << std::endl;
-            if (xCoord + xOffset >= 64) { // Sprite can't horizontally wrap
-                continue;
-            }
+        uint8_t rowData = this->read(this->indexRegister+rowId);
 
-            uint8_t selector = 1 << pixelRank;
+        // Sprite row lands on the packed row's bits [63-xCoord ; 56-xCoord]. Bits pushed past
+        // the right edge are dropped (sprite can't horizontally wrap).
+        uint64_t spriteMask = (static_cast<uint64_t>(rowData) << 56) >> xCoord;
 
-            bool pixelValue = (rowData & selector) >> pixelRank;
-
-            if (pixelValue == 1) {
-                if (this->displayState[xCoord+xOffset][yCoord+rowId]) {
-                    this->variableRegisters[0xf] = 1;
-                }
-
-                this->displayState[xCoord+xOffset][yCoord+rowId] = !this->displayState[xCoord+xOffset][yCoord+rowId];
-            }
+        if (this->displayState[yCoord+rowId] & spriteMask) {
+            this->variableRegisters[0xf] = 1;
         }
+
+        this->displayState[yCoord+rowId] ^= spriteMask;
     }
 
+    ++this->displayGeneration;
+    ++this->pendingDrawOps;
+
     this->pc  += 2;
 
-    std::cout << "TRACK: Drew " << (int)this->spriteSize << "-tall sprite @ (" << (int)xCoord << ", " << (int)yCoord << ")\n";
+    CHIP8_TRACE("TRACK: Drew " << (int)this->spriteSize << "-tall sprite @ (" << (int)xCoord << ", " << (int)yCoord << ")\n");
 }
 
 void Chip8::skip_if_key() {
     if (this->variableRegisters[this->firstRegister] == 0x1) {
-        if (glfwGetKey(this->display, GLFW_KEY_1) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_1) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `1` (`1` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `1` (`1` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `1` (`1` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `1` (`1` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x2) {
-        if (glfwGetKey(this->display, GLFW_KEY_2) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_2) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `2` (`2` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `2` (`2` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `2` (`2` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `2` (`2` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x3) {
-        if (glfwGetKey(this->display, GLFW_KEY_3) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_3) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `3` (`3` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `3` (`3` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `3` (`3` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `3` (`3` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0xC) {
-        if (glfwGetKey(this->display, GLFW_KEY_4) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_4) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `C` (`4` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `C` (`4` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `C` (`4` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `C` (`4` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x4) {
-        if (glfwGetKey(this->display, GLFW_KEY_Q) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_Q) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `4` (`Q` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `4` (`Q` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `4` (`Q` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `4` (`Q` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x5) {
-        if (glfwGetKey(this->display, GLFW_KEY_W) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_W) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `5` (`W` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `5` (`W` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `5` (`W` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `5` (`W` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x6) {
-        if (glfwGetKey(this->display, GLFW_KEY_E) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_E) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `6` (`E` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `6` (`E` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `6` (`E` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `6` (`E` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0xD) {
-        if (glfwGetKey(this->display, GLFW_KEY_R) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_R) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `D` (`R` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `D` (`R` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `D` (`R` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `D` (`R` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x7) {
-        if (glfwGetKey(this->display, GLFW_KEY_A) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_A) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `7` (`A` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `7` (`A` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `7` (`A` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `7` (`A` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x8) {
-        if (glfwGetKey(this->display, GLFW_KEY_S) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_S) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `8` (`S` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `8` (`S` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `8` (`S` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `8` (`S` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x9) {
-        if (glfwGetKey(this->display, GLFW_KEY_D) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_D) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `9` (`D` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `9` (`D` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `9` (`D` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `9` (`D` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0xE) {
-        if (glfwGetKey(this->display, GLFW_KEY_F) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_F) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `E` (`F` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `E` (`F` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `E` (`F` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `E` (`F` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0xA) {
-        if (glfwGetKey(this->display, GLFW_KEY_Z) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_Z) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `A` (`Z` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `A` (`Z` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `A` (`Z` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `A` (`Z` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x0) {
-        if (glfwGetKey(this->display, GLFW_KEY_X) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_X) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `0` (`X` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `0` (`X` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `0` (`X` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `0` (`X` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0xB) {
-        if (glfwGetKey(this->display, GLFW_KEY_S) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_S) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `B` (`C` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `B` (`C` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `B` (`C` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `B` (`C` on keyboard) wasn't PRESS.");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0xF) {
-        if (glfwGetKey(this->display, GLFW_KEY_V) == GLFW_PRESS) {
+        if (this->poll_key(GLFW_KEY_V) == GLFW_PRESS) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `F` (`V` on keyboard) was PRESS.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `F` (`V` on keyboard) was PRESS.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `F` (`V` on keyboard) wasn't PRESS.";
+            CHIP8_TRACE("TRACK: Didn't skip because key `F` (`V` on keyboard) wasn't PRESS.");
         }
     }
     
@@ -1040,116 +1411,116 @@ void Chip8::skip_if_key() {
 
 void Chip8::skip_if_not_key() {
     if (this->variableRegisters[this->firstRegister] == 0x1) {
-        if (glfwGetKey(this->display, GLFW_KEY_1) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_1) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `1` (`1` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `1` (`1` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `1` (`1` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `1` (`1` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x2) {
-        if (glfwGetKey(this->display, GLFW_KEY_2) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_2) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `2` (`2` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `2` (`2` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `2` (`2` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `2` (`2` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x3) {
-        if (glfwGetKey(this->display, GLFW_KEY_3) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_3) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `3` (`3` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `3` (`3` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `3` (`3` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `3` (`3` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0xC) {
-        if (glfwGetKey(this->display, GLFW_KEY_4) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_4) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `C` (`4` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `C` (`4` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `C` (`4` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `C` (`4` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x4) {
-        if (glfwGetKey(this->display, GLFW_KEY_Q) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_Q) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `4` (`Q` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `4` (`Q` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `4` (`Q` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `4` (`Q` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x5) {
-        if (glfwGetKey(this->display, GLFW_KEY_W) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_W) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `5` (`W` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `5` (`W` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `5` (`W` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `5` (`W` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x6) {
-        if (glfwGetKey(this->display, GLFW_KEY_E) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_E) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `6` (`E` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `6` (`E` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `6` (`E` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `6` (`E` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0xD) {
-        if (glfwGetKey(this->display, GLFW_KEY_R) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_R) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `D` (`R` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `D` (`R` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `D` (`R` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `D` (`R` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x7) {
-        if (glfwGetKey(this->display, GLFW_KEY_A) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_A) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `7` (`A` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `7` (`A` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `7` (`A` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `7` (`A` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x8) {
-        if (glfwGetKey(this->display, GLFW_KEY_S) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_S) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `8` (`S` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `8` (`S` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `8` (`S` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `8` (`S` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x9) {
-        if (glfwGetKey(this->display, GLFW_KEY_D) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_D) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `9` (`D` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `9` (`D` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `9` (`D` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `9` (`D` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0xE) {
-        if (glfwGetKey(this->display, GLFW_KEY_F) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_F) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `E` (`F` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `E` (`F` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `E` (`F` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `E` (`F` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0xA) {
-        if (glfwGetKey(this->display, GLFW_KEY_Z) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_Z) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `A` (`Z` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `A` (`Z` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `A` (`Z` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `A` (`Z` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0x0) {
-        if (glfwGetKey(this->display, GLFW_KEY_X) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_X) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `0` (`X` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `0` (`X` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `0` (`X` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `0` (`X` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0xB) {
-        if (glfwGetKey(this->display, GLFW_KEY_C) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_C) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `B` (`C` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `B` (`C` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `B` (`C` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `B` (`C` on keyboard) wasn't RELEASE.\n");
         }
     } else if (this->variableRegisters[this->firstRegister] == 0xF) {
-        if (glfwGetKey(this->display, GLFW_KEY_V) == GLFW_RELEASE) {
+        if (this->poll_key(GLFW_KEY_V) == GLFW_RELEASE) {
             this->pc += 2;
-            std::cout << "TRACK: Skipped because key `F` (`V` on keyboard) was RELEASE.\n";
+            CHIP8_TRACE("TRACK: Skipped because key `F` (`V` on keyboard) was RELEASE.\n");
         } else {
-            std::cout << "TRACK: Didn't skip because key `F` (`V` on keyboard) wasn't RELEASE.\n";
+            CHIP8_TRACE("TRACK: Didn't skip because key `F` (`V` on keyboard) wasn't RELEASE.\n");
         }
     }
     
@@ -1160,133 +1531,406 @@ void Chip8::set_reg_to_delay_timer() {
     this->variableRegisters[this->firstRegister] = this->delayTimer;
     this->pc += 2;
 
-    std::cout << "TRACK: Set " << this->firstRegister << "th register to the value of the delay timer (`" << this->delayTimer << "`)\n";
+    CHIP8_TRACE("TRACK: Set " << this->firstRegister << "th register to the value of the delay timer (`" << this->delayTimer << "`)\n");
 }
 
 void Chip8::set_delay_timer_to_reg() {
     this->delayTimer = this->variableRegisters[this->firstRegister];
     this->pc += 2;
 
-    std::cout << "TRACK: Set delay timer to " << this->firstRegister << "th register's value (`" << this->delayTimer << "`)\n";
+    CHIP8_TRACE("TRACK: Set delay timer to " << this->firstRegister << "th register's value (`" << this->delayTimer << "`)\n");
 }
 
 void Chip8::set_sound_timer_to_reg() {
     this->soundTimer = this->variableRegisters[this->firstRegister];
     this->pc += 2;
 
-    std::cout << "TRACK: Set sound timer to " << this->firstRegister << "th register's value (`" << this->soundTimer << "`)\n";
+    CHIP8_TRACE("TRACK: Set sound timer to " << this->firstRegister << "th register's value (`" << this->soundTimer << "`)\n");
 }
 
 void Chip8::add_to_index_register() {
     this->indexRegister += this->variableRegisters[this->firstRegister];
     this->pc += 2;
 
-    std::cout << "TRACK: Set index register to " << this->firstRegister << "th register's value (`" << this->indexRegister << "`)\n";
+    CHIP8_TRACE("TRACK: Set index register to " << this->firstRegister << "th register's value (`" << this->indexRegister << "`)\n");
 }
 
 void Chip8::get_key() {
-    if (glfwGetKey(this->display, GLFW_KEY_1) == GLFW_PRESS) {
+    uint16_t waitAddress = this->pc;
+
+    if (this->poll_key(GLFW_KEY_1) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0x1;
-        std::cout << "TRACK: Exiting getkey because key `1` (`1` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_2) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `1` (`1` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_2) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0x2;
-        std::cout << "TRACK: Exiting getkey because key `2` (`2` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_3) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `2` (`2` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_3) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0x3;
-        std::cout << "TRACK: Exiting getkey because key `3` (`3` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_4) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `3` (`3` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_4) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0xC;
-        std::cout << "TRACK: Exiting getkey because key `C` (`4` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_Q) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `C` (`4` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_Q) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0x4;
-        std::cout << "TRACK: Exiting getkey because key `4` (`Q` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_W) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `4` (`Q` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_W) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0x5;
-        std::cout << "TRACK: Exiting getkey because key `5` (`W` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_E) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `5` (`W` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_E) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0x6;
-        std::cout << "TRACK: Exiting getkey because key `6` (`E` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_R) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `6` (`E` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_R) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0xD;
-        std::cout << "TRACK: Exiting getkey because key `D` (`R` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_A) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `D` (`R` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_A) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0x7;
-        std::cout << "TRACK: Exiting getkey because key `7` (`A` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_S) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `7` (`A` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_S) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0x8;
-        std::cout << "TRACK: Exiting getkey because key `8` (`S` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_D) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `8` (`S` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_D) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0x9;
-        std::cout << "TRACK: Exiting getkey because key `9` (`D` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_F) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `9` (`D` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_F) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0xE;
-        std::cout << "TRACK: Exiting getkey because key `E` (`F` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_Z) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `E` (`F` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_Z) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0xA;
-        std::cout << "TRACK: Exiting getkey because key `A` (`Z` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_X) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `A` (`Z` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_X) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0x0;
-        std::cout << "TRACK: Exiting getkey because key `0` (`X` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_C) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `0` (`X` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_C) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0xB;
-        std::cout << "TRACK: Exiting getkey because key `B` (`C` on keyboard)\n";
-    } else if (glfwGetKey(this->display, GLFW_KEY_V) == GLFW_PRESS) {
+        CHIP8_TRACE("TRACK: Exiting getkey because key `B` (`C` on keyboard)\n");
+    } else if (this->poll_key(GLFW_KEY_V) == GLFW_PRESS) {
         this->pc += 2;
         this->variableRegisters[this->firstRegister] = 0xF;
-        std::cout << "TRACK: Exiting getkey because key `F` (`V` on keyboard)\n";
+        CHIP8_TRACE("TRACK: Exiting getkey because key `F` (`V` on keyboard)\n");
     }
 
-    std::cout << "TRACK: Getkey didn't detect any key\n";
+    CHIP8_TRACE("TRACK: Getkey didn't detect any key\n");
+
+    // FX0A runs again every cycle until a key is down : the timeline shows the whole wait as one event
+    if (Timeline::enabled()) {
+        uint64_t now = Timeline::now();
+        if (this->keyWaitStart == 0) {
+            this->keyWaitStart = now;
+        }
+        if (this->pc != waitAddress) {
+            Timeline::complete("FX0A", "guest", this->keyWaitStart, now, "key", this->variableRegisters[this->firstRegister]);
+            this->keyWaitStart = 0;
+        }
+    }
 }
 
 void Chip8::set_index_reg_to_character() {
     this->indexRegister = 0x50 + 5*this->variableRegisters[this->firstRegister];
     this->pc += 2;
 
-    std::cout << "Set index register to the position of system font's " << get_hex_representation(this->variableRegisters[this->firstRegister]) << " character\n";
+    CHIP8_TRACE("Set index register to the position of system font's " << get_hex_representation(this->variableRegisters[this->firstRegister]) << " character\n");
 }
 
 void Chip8::decimal_conversion() {
     uint8_t numberToConvert = this->variableRegisters[this->firstRegister];
-    this->ram[this->indexRegister+2]   = (numberToConvert    ) % 10;
-    this->ram[this->indexRegister+1] = (numberToConvert/10 ) % 10;
-    this->ram[this->indexRegister] =  numberToConvert/100;
+    this->write(this->indexRegister+2, (numberToConvert    ) % 10);
+    this->write(this->indexRegister+1, (numberToConvert/10 ) % 10);
+    this->write(this->indexRegister,    numberToConvert/100);
+    this->refresh_fused_ops(this->indexRegister, this->indexRegister+2); // Self-modifying code
     this->pc += 2;
 
-    std::cout << "TRACK: Filled ram from " << this->indexRegister << " to " << this->indexRegister+2 << " with decimal digits of `" << (int)this->variableRegisters[this->firstRegister] << "`\n";
+    CHIP8_TRACE("TRACK: Filled ram from " << this->indexRegister << " to " << this->indexRegister+2 << " with decimal digits of `" << (int)this->variableRegisters[this->firstRegister] << "`\n");
 }
 
 void Chip8::memory_store() {
     for (uint8_t i=0; i <= this->firstRegister; ++i) {
-        this->ram[this->indexRegister + i] = this->variableRegisters[i];
+        this->write(this->indexRegister + i, this->variableRegisters[i]);
     }
+    this->refresh_fused_ops(this->indexRegister, this->indexRegister + this->firstRegister); // Self-modifying code
 
     this->pc += 2;
-    std::cout << "TRACK: Saved memory from " << this->indexRegister << " to " << this->indexRegister + this->firstRegister << " on the ram (" << (int)this->firstRegister << " registers saved)\n";
+    CHIP8_TRACE("TRACK: Saved memory from " << this->indexRegister << " to " << this->indexRegister + this->firstRegister << " on the ram (" << (int)this->firstRegister << " registers saved)\n");
 }
 
 void Chip8::memory_load() {
     for (uint8_t i=0; i <= this->firstRegister; ++i) {
-        this->variableRegisters[i] = this->ram[this->indexRegister+i];
+        this->variableRegisters[i] = this->read(this->indexRegister+i);
     }
 
     this->pc += 2;
-    std::cout << "TRACK: Loaded memory from " << this->indexRegister << " to " << this->indexRegister + this->firstRegister << " (" << (int)this->firstRegister << " registers)\n";
+    CHIP8_TRACE("TRACK: Loaded memory from " << this->indexRegister << " to " << this->indexRegister + this->firstRegister << " (" << (int)this->firstRegister << " registers)\n");
+}
+
+/// `1NNN` jumping to itself : the guest idles until the budget runs out
+uint64_t Chip8::fused_idle_jump(uint64_t budget) {
+    CHIP8_TRACE("TRACK: Idled on `" << this->pc << "` for " << budget << " cycles\n");
+    this->collapsedCycles += budget - 1; // Only the jump is run
+    return budget;
+}
+
+/// `6XNN ; 7YNN`
+uint64_t Chip8::fused_set_add() {
+    const uint8_t *code = this->code_page().bytes.data() + this->pc % PAGE_SIZE;
+
+    this->variableRegisters[code[0] & 0xF] = code[1];
+    this->variableRegisters[code[2] & 0xF] += code[3];
+    this->pc += 4;
+
+    CHIP8_TRACE("TRACK: Fused set and add at `" << this->pc-4 << "`\n");
+    return 2;
+}
+
+/// `ANNN ; DXYN`
+uint64_t Chip8::fused_index_draw() {
+    const uint8_t *code = this->code_page().bytes.data() + this->pc % PAGE_SIZE;
+
+    this->indexRegister  = static_cast<uint16_t>((code[0] & 0xF) << 8 | code[1]);
+    this->firstRegister  = code[2] & 0xF;
+    this->secondRegister = code[3] >> 4;
+    this->spriteSize     = code[3] & 0xF;
+    this->pc += 2;
+
+    this->draw();
+    return 2;
+}
+
+/**
+ * `FX07 ; 3XNN ; 1NNN` : the usual wait on the delay timer. When the jump goes back to the `FX07`,
+ * nothing changes until the timer ticks, so every whole turn of the loop left in the budget is run at once.
+ */
+uint64_t Chip8::fused_delay_wait(uint64_t budget) {
+    const uint8_t *code = this->code_page().bytes.data() + this->pc % PAGE_SIZE;
+
+    uint16_t start        = this->pc;
+    uint8_t  waitRegister = code[0] & 0xF;
+    uint8_t  expected     = code[3];
+    uint16_t target       = static_cast<uint16_t>((code[4] & 0xF) << 8 | code[5]);
+
+    this->variableRegisters[waitRegister] = this->delayTimer;
+
+    if (this->variableRegisters[waitRegister] == expected) {
+        this->pc += 6; // Skips the jump
+        return 2;
+    }
+
+    this->pc = target;
+    if (target == start) {
+        uint64_t turns = budget / 3; // Whole turns only, the rest goes through `step()`
+        this->collapsedCycles += 3 * (turns - 1); // Only the first turn is run
+        return 3 * turns;
+    }
+    return 3;
+}
+
+/// `ANNN ; FX1E ; FY65` (neither FX1E nor FY65 touch VF, and FY65 leaves I alone)
+uint64_t Chip8::fused_index_load() {
+    const uint8_t *code = this->code_page().bytes.data() + this->pc % PAGE_SIZE;
+
+    this->indexRegister  = static_cast<uint16_t>((code[0] & 0xF) << 8 | code[1]);
+    this->indexRegister += this->variableRegisters[code[2] & 0xF];
+
+    uint8_t lastRegister = code[4] & 0xF;
+    for (uint8_t i=0; i <= lastRegister; ++i) {
+        this->variableRegisters[i] = this->read(this->indexRegister+i);
+    }
+    this->pc += 6;
+
+    CHIP8_TRACE("TRACK: Fused index load at `" << this->pc-6 << "`\n");
+    return 3;
+}
+
+/// Reclassifies every address whose fused sequence may cover a byte of [first ; last]
+void Chip8::refresh_fused_ops(int first, int last) {
+    int reach = 5; // Longest fused sequence is 6 bytes long
+    if (this->recompiled != NULL && this->recompiled->maxBlockSize > reach + 1) {
+        reach = this->recompiled->maxBlockSize - 1;
+    }
+
+    first = std::max(first - reach, 0);
+    last  = std::min(last, static_cast<int>(PAGE_SIZE * PAGE_COUNT) - 1);
+
+    for (int address = first; address <= last; ++address) {
+        FusedOp fusedOp = this->classify_fused_op(static_cast<uint16_t>(address));
+        if (fusedOp != this->get_fused_op(static_cast<uint16_t>(address))) { // Pages left as they were stay shared
+            this->writable_page(static_cast<uint16_t>(address)).fusedOps[address % PAGE_SIZE] = fusedOp;
+        }
+    }
+}
+
+/**
+ * Swaps every page for an identical one from a process-wide pool, which keeps a reference to each
+ * page it holds. Pooled pages are thus never the sole copy and get copied before any write, so
+ * thousands of cores loading the same program share a single image of it. Pages only the pool
+ * still references are pruned whenever it has doubled since the last pass, so programs nobody
+ * runs anymore don't stay resident.
+ */
+void Chip8::share_pages() {
+    static std::mutex                                                  poolMutex;
+    static std::unordered_map<uint64_t, std::shared_ptr<MemoryPage>> pool;          // Keyed by the XXH64 of the page
+    static size_t                                                      pruneSize = 64; // Pool size triggering the next pass
+
+    std::lock_guard<std::mutex> lock(poolMutex);
+
+    if (pool.size() >= pruneSize) {
+        for (std::unordered_map<uint64_t, std::shared_ptr<MemoryPage>>::iterator entry = pool.begin(); entry != pool.end();) {
+            if (entry->second.use_count() == 1) { // Can't go back up : new references are only handed out here
+                entry = pool.erase(entry);
+            } else {
+                ++entry;
+            }
+        }
+        pruneSize = std::max<size_t>(64, 2 * pool.size());
+    }
+
+    for (unsigned int pageId = 0; pageId < PAGE_COUNT; ++pageId) {
+        std::shared_ptr<MemoryPage> &page = this->pages[pageId];
+        uint64_t                     hash = xxhash64(page.get(), sizeof(MemoryPage));
+
+        std::shared_ptr<MemoryPage> &pooled = pool[hash];
+        if (!pooled) {
+            pooled = page;
+        } else if (pooled->bytes == page->bytes && pooled->fusedOps == page->fusedOps) {
+            page = pooled;
+        } // Otherwise a hash collision : the page stays private
+    }
+
+    this->codePage = this->pages[this->codePageId].get();
+}
+
+/// Adds what happened since the last call to the metrics of the calling thread
+void Chip8::report_metrics() {
+    MetricsShard &metrics = Metrics::local();
+
+    Metrics::add(metrics.instructions, this->instructionCount - this->reportedInstructions);
+    Metrics::add(metrics.collapsedCycles, this->collapsedCycles - this->reportedCollapsed);
+    Metrics::add(metrics.drawOps, this->pendingDrawOps);
+    Metrics::add(metrics.emulatedFrames, this->pendingFrames);
+
+    this->reportedInstructions = this->instructionCount;
+    this->reportedCollapsed    = this->collapsedCycles;
+    this->pendingDrawOps       = 0;
+    this->pendingFrames        = 0;
+}
+
+/// Calls nest up to `STACK_SIZE` deep, like on the original interpreters
+void Chip8::push_address(uint16_t address) {
+    if (this->stackSize == STACK_SIZE) {
+        throw std::runtime_error("Stack overflow : more than " + std::to_string(STACK_SIZE) + " nested calls");
+    }
+    this->addressStack[this->stackSize++] = address;
+}
+
+uint16_t Chip8::pop_address() {
+    if (this->stackSize == 0) {
+        throw std::runtime_error("Stack underflow : return without a call");
+    }
+    return this->addressStack[--this->stackSize];
+}
+
+Chip8::FusedOp Chip8::get_fused_op(uint16_t address) const {
+    return this->pages[address / PAGE_SIZE % PAGE_COUNT]->fusedOps[address % PAGE_SIZE];
+}
+
+/// Fused handler for the instructions at `address`. Waits keep theirs even in recompiled code, as it skips whole turns
+Chip8::FusedOp Chip8::classify_fused_op(uint16_t address) const {
+    bool native = this->is_native_block(address);
+
+    if (address + 6u > PAGE_SIZE * PAGE_COUNT) {
+        return native ? FusedOp::NATIVE : FusedOp::NONE;
+    }
+
+    uint16_t instructions[3];
+    for (size_t i = 0; i < 3; ++i) {
+        instructions[i] = static_cast<uint16_t>(this->read(address + 2*i) << 8 | this->read(address + 2*i + 1));
+    }
+
+    uint8_t  opcodes[3] = {static_cast<uint8_t>(instructions[0] >> 12), static_cast<uint8_t>(instructions[1] >> 12),
+                           static_cast<uint8_t>(instructions[2] >> 12)};
+    uint8_t  x          = (instructions[0] >> 8) & 0xF;
+    uint16_t target     = instructions[0] & 0xFFF;
+    bool     inPage     = address % PAGE_SIZE + 6 <= PAGE_SIZE; // The other handlers read their instructions from the code page
+
+    if (opcodes[0] == 0x1 && target == address) {
+        return FusedOp::IDLE_JUMP;
+    }
+    if (!inPage) {
+        return native ? FusedOp::NATIVE : FusedOp::NONE;
+    }
+    if ((instructions[0] & 0xF0FF) == 0xF007 && (instructions[1] & 0xFF00) == (0x3000 | x << 8) && opcodes[2] == 0x1) {
+        return FusedOp::DELAY_WAIT;
+    }
+    if (native) {
+        return FusedOp::NATIVE;
+    }
+    if (opcodes[0] == 0x6 && opcodes[1] == 0x7) {
+        return FusedOp::SET_ADD;
+    }
+    if (opcodes[0] == 0xA && opcodes[1] == 0xD) {
+        return FusedOp::INDEX_DRAW;
+    }
+    if (opcodes[0] == 0xA && (instructions[1] & 0xF0FF) == 0xF01E && (instructions[2] & 0xF0FF) == 0xF065) {
+        return FusedOp::INDEX_LOAD;
+    }
+    return FusedOp::NONE;
+}
+
+/// Whether a recompiled block starts at `address` and its guest code is still the one it was generated from
+bool Chip8::is_native_block(uint16_t address) const {
+    if (this->recompiled == NULL) {
+        return false;
+    }
+
+    const RecompiledBlock *blocksEnd = this->recompiled->blocks + this->recompiled->blockCount;
+    const RecompiledBlock *block     = std::lower_bound(this->recompiled->blocks, blocksEnd, address,
+                                                        [](const RecompiledBlock &left, uint16_t right) {
+                                                            return left.address < right;
+                                                        });
+    if (block == blocksEnd || block->address != address) {
+        return false;
+    }
+
+    for (uint16_t byteId = 0; byteId < block->size; ++byteId) {
+        if (this->read(address + byteId) != this->recompiled->image[address - 512 + byteId]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Page of zeros every core starts from, never written
+const std::shared_ptr<Chip8::MemoryPage> &Chip8::zero_page() {
+    static const std::shared_ptr<MemoryPage> ZERO_PAGE = []() {
+        std::shared_ptr<MemoryPage> page = std::make_shared<MemoryPage>();
+        page->bytes.fill(0);
+        page->fusedOps.fill(FusedOp::NONE);
+        return page;
+    }();
+    return ZERO_PAGE;
+}
+
+/// Zero page with the built-in font, the first page of every core
+const std::shared_ptr<Chip8::MemoryPage> &Chip8::font_page() {
+    static const std::shared_ptr<MemoryPage> FONT_PAGE = []() {
+        std::shared_ptr<MemoryPage> page = std::make_shared<MemoryPage>(*Chip8::zero_page());
+        std::copy(FONT, FONT + sizeof(FONT), page->bytes.begin() + FONT_ADDRESS);
+        return page;
+    }();
+    return FONT_PAGE;
 }
 
 void Chip8::glfw_error_callback(int error, const char *description) {
@@ -1295,28 +1939,28 @@ void Chip8::glfw_error_callback(int error, const char *description) {
 
 void Chip8::glfw_frame_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
+
+    Chip8 *emu = static_cast<Chip8 *>(glfwGetWindowUserPointer(window));
+    emu->redrawRequested = true; // The framebuffer content is undefined after a resize
 }
 
 void Chip8::glfw_key_callback(GLFWwindow *window, int key, int scancode, int action, int mods) {
     Chip8 *emu = static_cast<Chip8 *>(glfwGetWindowUserPointer(window));
+    if (action != GLFW_REPEAT) {
+        Metrics::add(Metrics::local().keyEvents, 1);
+        Timeline::instant(action == GLFW_PRESS ? "key press" : "key release", "host", "key", key);
+    }
+
     if (key == GLFW_KEY_L && action == GLFW_PRESS) {
         std::cout << "PRESSED L" << "\n";
+    } else if (key == GLFW_KEY_P && action == GLFW_PRESS) {
+        emu->print_profile_report(std::cout);
+    } else if (key == GLFW_KEY_J && action == GLFW_PRESS) {
+        emu->sleeper.print_report(std::cout);
     } else if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, true);
     } else if (key == GLFW_KEY_M && action == GLFW_PRESS) {
-        std::string pixels = "PIXELS :\n";
-        for (size_t j=0; j < 32; ++j) {
-            for (size_t i=0; i < 64; ++i) {
-                if (emu->get_display_state()[i][j]) {
-                    pixels.append("█");
-                } else {
-                    pixels.append(" ");
-                }
-            }
-            pixels.append("\n");
-        }
-        std::cout << pixels << "\nUNIFORMS :\n";
-        std::cout << "Model matrix     : " << emu->get_model_matrix_uniform_location()      << "\n";
+        std::cout << "PIXELS :\n" << TerminalRenderer::to_text(emu->get_display_view()) << "\nUNIFORMS :\n";
         std::cout << "Enabled color    : " << emu->get_enabled_color_uniform_location()     << "\n";
         std::cout << "Projection matrix: " << emu->get_projection_matrix_uniform_location() << "\n";
         
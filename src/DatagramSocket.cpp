@@ -0,0 +1,75 @@
+#include "DatagramSocket.hpp"
+#include "SocketAddress.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/un.h>
+#include <unistd.h>
+
+DatagramSocket::DatagramSocket(const std::string &localAddress, const std::string &remoteAddress) : fileDescriptor(-1), peerSize(0) {
+    std::memset(&this->peer, 0, sizeof(this->peer));
+    this->peerSize = resolve_socket_address(remoteAddress, "udp", SOCK_DGRAM, AF_UNSPEC, this->peer);
+
+    struct sockaddr_storage local;
+    socklen_t localSize = resolve_socket_address(localAddress, "udp", SOCK_DGRAM, this->peer.ss_family, local);
+
+    this->fileDescriptor = ::socket(this->peer.ss_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (this->fileDescriptor < 0) {
+        throw std::runtime_error(std::string("Socket error : ") + std::strerror(errno));
+    }
+
+    if (local.ss_family == AF_UNIX) {
+        this->unixPath = reinterpret_cast<const struct sockaddr_un &>(local).sun_path;
+        ::unlink(this->unixPath.c_str()); // Left over by a previous run
+    }
+
+    if (::bind(this->fileDescriptor, reinterpret_cast<const struct sockaddr *>(&local), localSize) != 0) {
+        std::string reason = std::strerror(errno);
+        ::close(this->fileDescriptor);
+        throw std::runtime_error("Socket error : can't bind `" + localAddress + "` (" + reason + ")");
+    }
+}
+
+DatagramSocket::~DatagramSocket() {
+    ::close(this->fileDescriptor);
+
+    if (!this->unixPath.empty()) {
+        ::unlink(this->unixPath.c_str());
+    }
+}
+
+/// Sends one datagram to the peer; false when it was dropped (e.g. the peer isn't listening yet)
+bool DatagramSocket::send(const uint8_t *data, size_t size) {
+    ssize_t sent;
+    do {
+        sent = ::sendto(this->fileDescriptor, data, size, 0, reinterpret_cast<const struct sockaddr *>(&this->peer), this->peerSize);
+    } while (sent < 0 && errno == EINTR);
+
+    return sent == static_cast<ssize_t>(size);
+}
+
+/// Size of the next pending datagram, copied into `buffer`, or -1 when there is none
+long DatagramSocket::receive(uint8_t *buffer, size_t capacity) {
+    while (true) {
+        ssize_t received = ::recv(this->fileDescriptor, buffer, capacity, 0);
+        if (received >= 0) {
+            return static_cast<long>(received);
+        }
+        if (errno != EINTR && errno != ECONNREFUSED) { // ECONNREFUSED : an earlier UDP send was refused, not this read
+            return -1;
+        }
+    }
+}
+
+/// Waits up to `timeoutMs` for a datagram to arrive
+bool DatagramSocket::wait(int timeoutMs) {
+    struct pollfd request;
+    request.fd      = this->fileDescriptor;
+    request.events  = POLLIN;
+    request.revents = 0;
+
+    return ::poll(&request, 1, timeoutMs) > 0;
+}
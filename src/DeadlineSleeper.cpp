@@ -0,0 +1,98 @@
+#include "DeadlineSleeper.hpp"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <time.h>
+
+DeadlineSleeper::DeadlineSleeper(double spinTail) : spinTail(spinTail), wakeups(0), overruns(0),
+                                                    totalLateness(0), maxLateness(0) {
+    this->latenessBuckets.fill(0);
+}
+
+/// Monotonic clock, in seconds (the clock deadlines are expressed in)
+double DeadlineSleeper::now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return static_cast<double>(time.tv_sec) + time.tv_nsec * 1e-9;
+}
+
+void DeadlineSleeper::sleep_until(double deadline) {
+    if (DeadlineSleeper::now() >= deadline) {
+        ++this->overruns; // Nothing to wait for : the caller is behind
+        return;
+    }
+
+    // Coarse part : the kernel wakes us up some time after `deadline - spinTail`
+    double wakeTime = deadline - this->spinTail;
+
+    struct timespec target;
+    target.tv_sec  = static_cast<time_t>(std::floor(wakeTime));
+    target.tv_nsec = static_cast<long>((wakeTime - std::floor(wakeTime)) * 1e9);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, NULL) == EINTR) {
+        // Interrupted by a signal : sleeps again to the same absolute time
+    }
+
+    // Fine part : spins on the clock for the last few hundred microseconds
+    double current = DeadlineSleeper::now();
+    while (current < deadline) {
+        current = DeadlineSleeper::now();
+    }
+
+    double lateness = current - deadline;
+    size_t bucket   = 0;
+    for (double bound = 1e-6; lateness >= bound && bucket + 1 < BUCKET_COUNT; bound *= 2) {
+        ++bucket;
+    }
+
+    ++this->wakeups;
+    ++this->latenessBuckets[bucket];
+    this->totalLateness += lateness;
+    if (lateness > this->maxLateness) {
+        this->maxLateness = lateness;
+    }
+}
+
+void DeadlineSleeper::print_report(std::ostream &output) const {
+    char line[160];
+    std::snprintf(line, sizeof(line), "JITTER : %llu wake-ups (%llu overruns), mean %.1f us, p50 < %.0f us, p99 < %.0f us, max %.1f us\n",
+                  (unsigned long long)this->wakeups, (unsigned long long)this->overruns, this->get_mean_lateness() * 1e6,
+                  this->get_lateness_percentile(50) * 1e6, this->get_lateness_percentile(99) * 1e6, this->maxLateness * 1e6);
+    output << line;
+}
+
+void DeadlineSleeper::set_spin_tail(double spinTail) {
+    this->spinTail = spinTail > 0 ? spinTail : 0;
+}
+
+uint64_t DeadlineSleeper::get_wakeup_count() const {
+    return this->wakeups;
+}
+
+uint64_t DeadlineSleeper::get_overrun_count() const {
+    return this->overruns;
+}
+
+double DeadlineSleeper::get_mean_lateness() const {
+    return this->wakeups > 0 ? this->totalLateness / this->wakeups : 0.0;
+}
+
+double DeadlineSleeper::get_max_lateness() const {
+    return this->maxLateness;
+}
+
+/// Upper bound of the histogram bucket holding the given percentile of wake-up lateness, in seconds
+double DeadlineSleeper::get_lateness_percentile(double percentile) const {
+    uint64_t rank = static_cast<uint64_t>(std::ceil(this->wakeups * percentile / 100.0));
+    uint64_t seen = 0;
+
+    for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+        seen += this->latenessBuckets[bucket];
+        if (seen >= rank && seen > 0) {
+            return std::ldexp(1e-6, static_cast<int>(bucket)); // Bucket `b` ends at 2^b us
+        }
+    }
+    return this->maxLateness;
+}
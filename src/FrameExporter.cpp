@@ -0,0 +1,184 @@
+#include "FrameExporter.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    const char    FRAME_MARKER[]    = "FRAME\n";
+    const size_t  FRAME_MARKER_SIZE = sizeof(FRAME_MARKER) - 1;
+
+    const uint8_t LUMA_OFF = 16;  // Studio-range black
+    const uint8_t LUMA_ON  = 235; // Studio-range white
+    const uint8_t CHROMA   = 128; // No color
+}
+
+FrameExporter::FrameExporter(const std::string &path, Format format, unsigned int scale, unsigned int frameRate, unsigned int poolSize)
+    : output(NULL),           ownsOutput(false),
+      format(format),         scale(scale == 0 ? 1 : scale),
+      frameRate(frameRate == 0 ? 60 : frameRate),
+      slots(poolSize == 0 ? 1 : poolSize),
+      writeCursor(0),         readCursor(0),
+      lastHash(0),            hasLastHash(false),
+      writtenFrames(0),       duplicateFrames(0),
+      overflowFrames(0),      stopping(false) {
+    if (path == "-") {
+        this->output = stdout;
+    } else {
+        this->output     = std::fopen(path.c_str(), "wb");
+        this->ownsOutput = true;
+    }
+
+    if (this->output == NULL) {
+        throw std::runtime_error("Could not open frame export destination : `" + path + "`");
+    }
+
+    const size_t width  = 64 * this->scale;
+    const size_t height = 32 * this->scale;
+
+    if (this->format == Format::Y4M) {
+        // Marker, luma plane and both (constant) chroma planes are laid out once, only luma changes per frame
+        size_t chromaSize = ((width+1)/2) * ((height+1)/2);
+        this->encodeBuffer.assign(FRAME_MARKER_SIZE + width*height + 2*chromaSize, CHROMA);
+        std::memcpy(this->encodeBuffer.data(), FRAME_MARKER, FRAME_MARKER_SIZE);
+    } else {
+        this->encodeBuffer.assign(width*height*3, 0);
+    }
+
+    this->write_header();
+
+    this->worker = std::thread(&FrameExporter::worker_loop, this);
+}
+
+FrameExporter::~FrameExporter() {
+    this->finish();
+}
+
+bool FrameExporter::submit(const DisplayView &view, uint64_t hash) {
+    if (this->hasLastHash && hash == this->lastHash) {
+        ++this->duplicateFrames;
+        return false;
+    }
+
+    uint64_t write = this->writeCursor.load(std::memory_order_relaxed);
+    uint64_t read  = this->readCursor.load(std::memory_order_acquire);
+
+    if (write - read >= this->slots.size()) { // Encoder is behind : drop rather than stall emulation
+        ++this->overflowFrames;
+        return false;
+    }
+
+    std::array<uint64_t, 32> &slot = this->slots[write % this->slots.size()];
+    for (unsigned int y = 0; y < DisplayView::HEIGHT; ++y) {
+        slot[y] = view.row(y);
+    }
+    this->writeCursor.store(write + 1, std::memory_order_release);
+
+    this->lastHash    = hash;
+    this->hasLastHash = true;
+
+    this->wake.notify_one();
+
+    return true;
+}
+
+void FrameExporter::wait_for_slot() {
+    uint64_t write = this->writeCursor.load(std::memory_order_relaxed);
+    while (write - this->readCursor.load(std::memory_order_acquire) >= this->slots.size()) {
+        std::this_thread::yield();
+    }
+}
+
+void FrameExporter::finish() {
+    if (!this->worker.joinable()) {
+        return;
+    }
+
+    this->stopping.store(true);
+    this->wake.notify_one();
+    this->worker.join();
+
+    std::fflush(this->output);
+    if (this->ownsOutput) {
+        std::fclose(this->output);
+    }
+    this->output = NULL;
+}
+
+uint64_t FrameExporter::get_written_frames() const {
+    return this->writtenFrames.load();
+}
+
+uint64_t FrameExporter::get_duplicate_frames() const {
+    return this->duplicateFrames;
+}
+
+uint64_t FrameExporter::get_overflow_frames() const {
+    return this->overflowFrames;
+}
+
+void FrameExporter::write_header() {
+    if (this->format == Format::Y4M) {
+        std::fprintf(this->output, "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C420jpeg\n", 64*this->scale, 32*this->scale, this->frameRate);
+    }
+}
+
+void FrameExporter::encode(const std::array<uint64_t, 32> &rows) {
+    const size_t width = 64 * this->scale;
+
+    if (this->format == Format::Y4M) {
+        uint8_t *luma = this->encodeBuffer.data() + FRAME_MARKER_SIZE;
+
+        for (size_t y = 0; y < 32; ++y) {
+            uint8_t *line = luma + y*this->scale*width;
+
+            for (size_t x = 0; x < 64; ++x) {
+                uint8_t value = ((rows[y] >> (63 - x)) & 1) ? LUMA_ON : LUMA_OFF;
+                std::memset(line + x*this->scale, value, this->scale);
+            }
+
+            for (size_t copy = 1; copy < this->scale; ++copy) {
+                std::memcpy(line + copy*width, line, width);
+            }
+        }
+    } else {
+        const size_t lineSize = width * 3;
+
+        for (size_t y = 0; y < 32; ++y) {
+            uint8_t *line = this->encodeBuffer.data() + y*this->scale*lineSize;
+
+            for (size_t x = 0; x < 64; ++x) {
+                uint8_t value = ((rows[y] >> (63 - x)) & 1) ? 255 : 0;
+                std::memset(line + x*this->scale*3, value, this->scale*3);
+            }
+
+            for (size_t copy = 1; copy < this->scale; ++copy) {
+                std::memcpy(line + copy*lineSize, line, lineSize);
+            }
+        }
+    }
+}
+
+void FrameExporter::worker_loop() {
+    while (true) {
+        uint64_t read  = this->readCursor.load(std::memory_order_relaxed);
+        uint64_t write = this->writeCursor.load(std::memory_order_acquire);
+
+        if (read == write) {
+            if (this->stopping.load()) {
+                break;
+            }
+
+            // The producer notifies without taking the lock, so a wakeup can be missed : the timeout bounds it
+            std::unique_lock<std::mutex> lock(this->wakeMutex);
+            this->wake.wait_for(lock, std::chrono::milliseconds(5));
+            continue;
+        }
+
+        this->encode(this->slots[read % this->slots.size()]);
+        this->readCursor.store(read + 1, std::memory_order_release);
+
+        std::fwrite(this->encodeBuffer.data(), 1, this->encodeBuffer.size(), this->output);
+        this->writtenFrames.fetch_add(1);
+    }
+}
@@ -0,0 +1,85 @@
+#include "FramePacer.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+FramePacer::FramePacer(double refreshRate, unsigned int maxCatchUpFrames) : frameDuration(0),
+                                                                            maxCatchUpFrames(maxCatchUpFrames),
+                                                                            nextFrameTime(0),
+                                                                            emulatedFrames(0),
+                                                                            renderedFrames(0),
+                                                                            skippedFrames(0),
+                                                                            droppedFrames(0) {
+    this->set_refresh_rate(refreshRate);
+    this->set_max_catch_up_frames(maxCatchUpFrames);
+}
+
+/// Makes the first frame due right away
+void FramePacer::reset(double now) {
+    this->nextFrameTime = now;
+}
+
+/// Number of emulated frames to run before rendering at host time `now` (0 : nothing to do yet)
+unsigned int FramePacer::frames_due(double now) {
+    if (now < this->nextFrameTime) {
+        return 0;
+    }
+
+    double   late   = now - this->nextFrameTime;
+    uint64_t behind = static_cast<uint64_t>(std::floor(late / this->frameDuration)) + 1;
+
+    unsigned int due = behind > this->maxCatchUpFrames ? this->maxCatchUpFrames : static_cast<unsigned int>(behind);
+
+    if (behind > due) { // Too far behind : gives up on the extra frames and starts again from now
+        this->droppedFrames += behind - due;
+        this->nextFrameTime  = now + this->frameDuration;
+    } else {
+        this->nextFrameTime += due * this->frameDuration;
+    }
+
+    this->emulatedFrames += due;
+    this->skippedFrames  += due - 1;
+
+    return due;
+}
+
+/// Counts a swap : idle iterations that leave the previous frame on screen aren't rendered frames
+void FramePacer::frame_presented() {
+    ++this->renderedFrames;
+}
+
+void FramePacer::set_refresh_rate(double refreshRate) {
+    if (!(refreshRate > 0)) {
+        throw std::runtime_error("Invalid refresh rate : " + std::to_string(refreshRate));
+    }
+    this->frameDuration = 1.0 / refreshRate;
+}
+
+void FramePacer::set_max_catch_up_frames(unsigned int maxCatchUpFrames) {
+    this->maxCatchUpFrames = maxCatchUpFrames > 0 ? maxCatchUpFrames : 1;
+}
+
+double FramePacer::get_next_frame_time() const {
+    return this->nextFrameTime;
+}
+
+double FramePacer::get_refresh_rate() const {
+    return 1.0 / this->frameDuration;
+}
+
+uint64_t FramePacer::get_emulated_frames() const {
+    return this->emulatedFrames;
+}
+
+uint64_t FramePacer::get_rendered_frames() const {
+    return this->renderedFrames;
+}
+
+uint64_t FramePacer::get_skipped_frames() const {
+    return this->skippedFrames;
+}
+
+uint64_t FramePacer::get_dropped_frames() const {
+    return this->droppedFrames;
+}
@@ -0,0 +1,164 @@
+#include "GridRenderer.hpp"
+#include "EmbeddedShaders.hpp"
+#include "ShaderProgram.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+GridRenderer::GridRenderer() {
+    float squareVertices[] = {1.0f, 1.0f,    1.0f,  0.0f,    0.0f,  0.0f,    0.0f, 1.0f};
+    //float squareVertices[] = {0.0f, 0.5f,    0.0f,  -0.5f,    -1.0f,  -0.5f,    -1.0f, 0.5f};
+    //float squareVertices[] = {0.5f, 0.5f,    0.5f, -0.5f,   -0.5f, -0.5f,   -0.5f, 0.5f};
+    unsigned int squareIndices[] = {0, 1, 3,    1, 2, 3};
+    
+    glGenBuffers(1, &this->vboAddress);
+    glGenBuffers(1, &this->eboAddress);
+    glGenVertexArrays(1, &this->vaoAddress);
+
+    glBindVertexArray(this->vaoAddress);
+    glBindBuffer(GL_ARRAY_BUFFER,         this->vboAddress);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->eboAddress);
+
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(squareIndices), squareIndices, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(squareVertices), squareVertices, GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0); // Vertices
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2*sizeof(float), (void*)0);
+
+    this->pixelColor = glm::vec4(1.0, 1.0, 1.0, 1.0);
+
+    this->programAddress = create_shader_program("grid", GRID_VERTEX_SHADER, GRID_FRAGMENT_SHADER);
+
+    glUseProgram(this->programAddress);
+
+    this->enabledColorUniformLocation     = glGetUniformLocation(this->programAddress, "enabledColor");
+    this->projectionMatrixUniformLocation = glGetUniformLocation(this->programAddress, "projection");
+
+    glm::mat4 projectionMatrix = glm::ortho(0.0f, 64.0f, 32.0f, 0.0f, -1.0f, 1.0f);
+
+    glUniform4fv(this->enabledColorUniformLocation, 1, glm::value_ptr(this->pixelColor)); // Sending opaque white to the shader
+    glUniformMatrix4fv(this->projectionMatrixUniformLocation, 1, GL_FALSE, glm::value_ptr(projectionMatrix));
+    glUseProgram(0);
+
+    glBindVertexArray(0); // Unbinding VAO first
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    // Display state buffer : REGION_COUNT regions, written in turn through a persistent mapping
+    GLint offsetAlignment = 1;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+
+    this->regionSize = (DISPLAY_BYTES + offsetAlignment - 1) / offsetAlignment * offsetAlignment;
+
+    const GLbitfield mappingFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenBuffers(1, &this->displayBufferAddress);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->displayBufferAddress);
+    glBufferStorage(GL_SHADER_STORAGE_BUFFER, this->regionSize * REGION_COUNT, NULL, mappingFlags);
+
+    this->displayMapping = static_cast<uint8_t *>(glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, this->regionSize * REGION_COUNT, mappingFlags));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    if (this->displayMapping == NULL) {
+        this->delete_objects(); // The destructor won't run
+        throw std::runtime_error("OpenGL error : Failed to map the display state buffer");
+    }
+
+    this->regionFences.fill(NULL);
+    this->currentRegion      = 0;
+    this->uploadedRows       = NULL;
+    this->uploadedGeneration = 0;
+}
+
+GridRenderer::~GridRenderer() {
+    for (size_t regionId = 0; regionId < REGION_COUNT; ++regionId) {
+        if (this->regionFences[regionId] != NULL) {
+            glDeleteSync(this->regionFences[regionId]);
+        }
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->displayBufferAddress);
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    this->delete_objects();
+}
+
+/// Deletes the buffers, VAO and program (the state buffer once unmapped)
+void GridRenderer::delete_objects() {
+    glDeleteBuffers(1, &this->displayBufferAddress);
+    glDeleteProgram(this->programAddress);
+    glDeleteVertexArrays(1, &this->vaoAddress);
+    glDeleteBuffers(1, &this->vboAddress);
+    glDeleteBuffers(1, &this->eboAddress);
+}
+
+void GridRenderer::draw(const DisplayView &view) {
+    bool changed = view.rows != this->uploadedRows || view.generation != this->uploadedGeneration;
+
+    if (changed) { // An unchanged display is drawn again from the region it's already in
+        this->currentRegion = (this->currentRegion + 1) % REGION_COUNT;
+        this->upload(view);
+    }
+
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glBindVertexArray(this->vaoAddress);
+    glUseProgram(this->programAddress);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, this->displayBufferAddress, this->currentRegion * this->regionSize, DISPLAY_BYTES);
+
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, DisplayView::WIDTH * DisplayView::HEIGHT); // One instance per pixel
+
+    // The region can't be written again before this draw (the last one reading it) is done
+    GLsync &fence = this->regionFences[this->currentRegion];
+    if (fence != NULL) {
+        glDeleteSync(fence);
+    }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
+
+/// Writes the display rows into the current region, waiting first if the GPU may still read it
+void GridRenderer::upload(const DisplayView &view) {
+    GLsync &fence = this->regionFences[this->currentRegion];
+
+    if (fence != NULL) {
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        while (status == GL_TIMEOUT_EXPIRED) {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        }
+
+        glDeleteSync(fence);
+        fence = NULL;
+    }
+
+    // Two words per row, left half first : GLSL 4.40 has no 64-bits integers
+    uint32_t *words = reinterpret_cast<uint32_t *>(this->displayMapping + this->currentRegion * this->regionSize);
+
+    for (unsigned int y = 0; y < DisplayView::HEIGHT; ++y) {
+        uint64_t row = view.row(y);
+        words[2*y]   = static_cast<uint32_t>(row >> 32);
+        words[2*y+1] = static_cast<uint32_t>(row);
+    }
+
+    this->uploadedRows       = view.rows;
+    this->uploadedGeneration = view.generation;
+}
+
+GLint GridRenderer::get_projection_matrix_uniform_location() const {
+    return this->projectionMatrixUniformLocation;
+}
+
+GLint GridRenderer::get_enabled_color_uniform_location() const {
+    return this->enabledColorUniformLocation;
+}
+
+GLint GridRenderer::get_program_address() const {
+    return this->programAddress;
+}
@@ -0,0 +1,128 @@
+#include "Hash.hpp"
+
+namespace {
+    const uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+    const uint64_t PRIME_3 = 0x165667B19E3779F9ULL;
+    const uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+    const uint64_t PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+    inline uint64_t rotate_left(uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    inline uint64_t lane_round(uint64_t accumulator, uint64_t lane) {
+        accumulator += lane * PRIME_2;
+        accumulator  = rotate_left(accumulator, 31);
+        return accumulator * PRIME_1;
+    }
+
+    inline uint64_t merge_round(uint64_t accumulator, uint64_t value) {
+        accumulator ^= lane_round(0, value);
+        return accumulator * PRIME_1 + PRIME_4;
+    }
+
+    inline uint64_t read_le64(const uint8_t *bytes) {
+        uint64_t value = 0;
+        for (int i = 7; i >= 0; --i) {
+            value = (value << 8) | bytes[i];
+        }
+        return value;
+    }
+
+    inline uint32_t read_le32(const uint8_t *bytes) {
+        return  static_cast<uint32_t>(bytes[0])        | (static_cast<uint32_t>(bytes[1]) << 8)
+             | (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    // Consumes the 32-bytes stripes and returns the converged accumulator (or the short-input seed)
+    template <typename LaneReader>
+    uint64_t hash_stripes(LaneReader readLane, size_t laneCount, uint64_t seed) {
+        if (laneCount < 4) {
+            return seed + PRIME_5;
+        }
+
+        uint64_t v1 = seed + PRIME_1 + PRIME_2;
+        uint64_t v2 = seed + PRIME_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME_1;
+
+        for (size_t lane = 0; lane + 4 <= laneCount; lane += 4) {
+            v1 = lane_round(v1, readLane(lane));
+            v2 = lane_round(v2, readLane(lane+1));
+            v3 = lane_round(v3, readLane(lane+2));
+            v4 = lane_round(v4, readLane(lane+3));
+        }
+
+        uint64_t hash = rotate_left(v1, 1) + rotate_left(v2, 7) + rotate_left(v3, 12) + rotate_left(v4, 18);
+        hash = merge_round(hash, v1);
+        hash = merge_round(hash, v2);
+        hash = merge_round(hash, v3);
+        hash = merge_round(hash, v4);
+
+        return hash;
+    }
+
+    inline uint64_t mix_lane(uint64_t hash, uint64_t lane) {
+        hash ^= lane_round(0, lane);
+        return rotate_left(hash, 27) * PRIME_1 + PRIME_4;
+    }
+
+    inline uint64_t avalanche(uint64_t hash) {
+        hash ^= hash >> 33;
+        hash *= PRIME_2;
+        hash ^= hash >> 29;
+        hash *= PRIME_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    struct ByteLaneReader {
+        const uint8_t *bytes;
+        uint64_t operator()(size_t lane) const { return read_le64(this->bytes + 8*lane); }
+    };
+
+    struct WordLaneReader {
+        const uint64_t *words;
+        uint64_t operator()(size_t lane) const { return this->words[lane]; }
+    };
+}
+
+uint64_t xxhash64(const void *data, size_t length, uint64_t seed) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    ByteLaneReader reader = {bytes};
+
+    size_t laneCount = length / 8;
+    uint64_t hash = hash_stripes(reader, laneCount, seed) + length;
+
+    size_t lane = (laneCount / 4) * 4;
+    for (; lane < laneCount; ++lane) {
+        hash = mix_lane(hash, reader(lane));
+    }
+
+    size_t offset = laneCount * 8;
+    if (offset + 4 <= length) {
+        hash ^= static_cast<uint64_t>(read_le32(bytes + offset)) * PRIME_1;
+        hash  = rotate_left(hash, 23) * PRIME_2 + PRIME_3;
+        offset += 4;
+    }
+
+    for (; offset < length; ++offset) {
+        hash ^= bytes[offset] * PRIME_5;
+        hash  = rotate_left(hash, 11) * PRIME_1;
+    }
+
+    return avalanche(hash);
+}
+
+uint64_t xxhash64_words(const uint64_t *words, size_t count, uint64_t seed) {
+    WordLaneReader reader = {words};
+
+    uint64_t hash = hash_stripes(reader, count, seed) + count*8;
+
+    for (size_t lane = (count / 4) * 4; lane < count; ++lane) {
+        hash = mix_lane(hash, reader(lane));
+    }
+
+    return avalanche(hash);
+}
@@ -0,0 +1,78 @@
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram() : counts((MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS, 0), total(0), sum(0),
+                                       min(0), max(0) {}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    ++this->counts[LatencyHistogram::bucket_of(nanoseconds)];
+
+    this->min    = this->total == 0 ? nanoseconds : std::min(this->min, nanoseconds);
+    this->max    = std::max(this->max, nanoseconds);
+    this->sum   += nanoseconds;
+    ++this->total;
+}
+
+void LatencyHistogram::reset() {
+    std::fill(this->counts.begin(), this->counts.end(), 0);
+    this->total = this->sum = this->min = this->max = 0;
+}
+
+uint64_t LatencyHistogram::get_count() const {
+    return this->total;
+}
+
+uint64_t LatencyHistogram::get_min() const {
+    return this->min;
+}
+
+uint64_t LatencyHistogram::get_max() const {
+    return this->max;
+}
+
+double LatencyHistogram::get_mean() const {
+    return this->total > 0 ? static_cast<double>(this->sum) / this->total : 0.0;
+}
+
+/// Value at or below which `percentile` % of the recordings are, within the bucket precision (never above `max`)
+uint64_t LatencyHistogram::get_percentile(double percentile) const {
+    uint64_t rank = static_cast<uint64_t>(std::ceil(this->total * std::min(percentile, 100.0) / 100.0));
+    uint64_t seen = 0;
+
+    for (size_t bucket = 0; bucket < this->counts.size(); ++bucket) {
+        seen += this->counts[bucket];
+        if (seen >= rank && seen > 0) {
+            return std::min(LatencyHistogram::highest_value_of(bucket), this->max);
+        }
+    }
+    return this->max;
+}
+
+/// Values below `SUB_BUCKETS` get a bucket each; above, bucket `(e - SUB_BUCKET_BITS + 1, top bits)` for 2^e <= value < 2^(e+1)
+size_t LatencyHistogram::bucket_of(uint64_t nanoseconds) {
+    if (nanoseconds < SUB_BUCKETS) {
+        return static_cast<size_t>(nanoseconds);
+    }
+
+    unsigned int exponent = 63 - static_cast<unsigned int>(__builtin_clzll(nanoseconds));
+    if (exponent >= MAX_EXPONENT) {
+        return (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS - 1;
+    }
+
+    uint64_t subBucket = (nanoseconds >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKETS; // Next SUB_BUCKET_BITS bits under the top one
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + static_cast<size_t>(subBucket);
+}
+
+uint64_t LatencyHistogram::highest_value_of(size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+
+    unsigned int exponent  = static_cast<unsigned int>(bucket / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+    uint64_t     subBucket = bucket % SUB_BUCKETS;
+    uint64_t     width     = uint64_t(1) << (exponent - SUB_BUCKET_BITS);
+
+    return ((SUB_BUCKETS + subBucket) << (exponent - SUB_BUCKET_BITS)) + width - 1;
+}
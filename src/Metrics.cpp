@@ -0,0 +1,149 @@
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+const std::array<double, MetricsHistogram::BUCKET_COUNT - 1> Metrics::BUCKET_BOUNDS = {{
+    0.0005, 0.001, 0.002, 0.004, 0.008, 0.016, 0.033, 0.066, 0.133, 0.25, 0.5, 1.0
+}};
+
+namespace {
+    /// Sum of the histograms of every shard
+    struct HistogramTotals {
+        std::array<uint64_t, MetricsHistogram::BUCKET_COUNT> buckets;
+        uint64_t                                             sumNs;
+    };
+
+    uint64_t read(const std::atomic<uint64_t> &counter) {
+        return counter.load(std::memory_order_relaxed);
+    }
+
+    void accumulate(HistogramTotals &totals, const MetricsHistogram &histogram) {
+        for (size_t bucketId = 0; bucketId < MetricsHistogram::BUCKET_COUNT; ++bucketId) {
+            totals.buckets[bucketId] += read(histogram.buckets[bucketId]);
+        }
+        totals.sumNs += read(histogram.sumNs);
+    }
+
+    void write_metric(std::ostringstream &output, const char *name, const char *type, const char *help, uint64_t value) {
+        output << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n' << name << ' ' << value << '\n';
+    }
+
+    void write_histogram(std::ostringstream &output, const char *name, const char *help, const HistogramTotals &totals) {
+        output << "# HELP " << name << ' ' << help << "\n# TYPE " << name << " histogram\n";
+
+        uint64_t count = 0; // Prometheus buckets are cumulative
+        for (size_t bucketId = 0; bucketId < MetricsHistogram::BUCKET_COUNT; ++bucketId) {
+            count += totals.buckets[bucketId];
+            output << name << "_bucket{le=\"";
+            if (bucketId < Metrics::BUCKET_BOUNDS.size()) {
+                output << Metrics::BUCKET_BOUNDS[bucketId];
+            } else {
+                output << "+Inf";
+            }
+            output << "\"} " << count << '\n';
+        }
+        output << name << "_sum " << static_cast<double>(totals.sumNs) / 1e9 << '\n' << name << "_count " << count << '\n';
+    }
+}
+
+/// Hands the shard of a thread back to `Metrics` when the thread exits
+struct Metrics::ShardLease {
+    MetricsShard *shard; ///< NULL until the thread records something
+
+    ShardLease() : shard(NULL) {}
+
+    ~ShardLease() {
+        if (this->shard != NULL) {
+            Metrics::instance().release_shard(this->shard);
+        }
+    }
+};
+
+Metrics::Metrics() {}
+
+Metrics &Metrics::instance() {
+    static Metrics metrics;
+    return metrics;
+}
+
+/// Shard of the calling thread
+MetricsShard &Metrics::local() {
+    static thread_local ShardLease lease;
+
+    if (lease.shard == NULL) {
+        lease.shard = Metrics::instance().acquire_shard();
+    }
+    return *lease.shard;
+}
+
+/// Adds to a counter of the caller's own shard : a single writer needs no atomic read-modify-write
+void Metrics::add(std::atomic<uint64_t> &counter, uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+void Metrics::observe(MetricsHistogram &histogram, double seconds) {
+    seconds = std::max(seconds, 0.0);
+
+    size_t bucketId = static_cast<size_t>(std::lower_bound(BUCKET_BOUNDS.begin(), BUCKET_BOUNDS.end(), seconds) - BUCKET_BOUNDS.begin());
+    Metrics::add(histogram.buckets[bucketId], 1);
+    Metrics::add(histogram.sumNs, static_cast<uint64_t>(std::llround(seconds * 1e9)));
+}
+
+/// Every metric in the Prometheus text exposition format (version 0.0.4)
+std::string Metrics::render() {
+    uint64_t instructions = 0, collapsedCycles = 0, emulatedFrames = 0, renderedFrames = 0, keyEvents = 0, drawOps = 0, created = 0, destroyed = 0;
+    HistogramTotals frameTime    = HistogramTotals();
+    HistogramTotals emulationLag = HistogramTotals();
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        for (size_t shardId = 0; shardId < this->shards.size(); ++shardId) {
+            const MetricsShard &shard = *this->shards[shardId];
+
+            instructions    += read(shard.instructions);
+            collapsedCycles += read(shard.collapsedCycles);
+            emulatedFrames  += read(shard.emulatedFrames);
+            renderedFrames  += read(shard.renderedFrames);
+            keyEvents       += read(shard.keyEvents);
+            drawOps         += read(shard.drawOps);
+            created         += read(shard.coresCreated);
+            destroyed       += read(shard.coresDestroyed);
+            accumulate(frameTime, shard.frameTime);
+            accumulate(emulationLag, shard.emulationLag);
+        }
+    }
+
+    std::ostringstream output;
+    write_metric(output, "chip8_instructions_total", "counter", "Guest instructions executed.", instructions);
+    write_metric(output, "chip8_collapsed_cycles_total", "counter", "Instructions skipped by fused waits, counted as executed.", collapsedCycles);
+    write_metric(output, "chip8_emulated_frames_total", "counter", "Emulated frames run.", emulatedFrames);
+    write_metric(output, "chip8_rendered_frames_total", "counter", "Frames presented in a window.", renderedFrames);
+    write_metric(output, "chip8_key_events_total", "counter", "Key presses and releases.", keyEvents);
+    write_metric(output, "chip8_draw_ops_total", "counter", "DXYN sprite draws executed.", drawOps);
+    write_metric(output, "chip8_instances", "gauge", "Emulator cores alive.", created >= destroyed ? created - destroyed : 0);
+    write_histogram(output, "chip8_frame_time_seconds", "Host time between two presented frames.", frameTime);
+    write_histogram(output, "chip8_emulation_lag_seconds", "Delay between the deadline of an emulated frame and its start.", emulationLag);
+
+    return output.str();
+}
+
+MetricsShard *Metrics::acquire_shard() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    if (!this->freeShards.empty()) {
+        MetricsShard *shard = this->freeShards.back();
+        this->freeShards.pop_back();
+        return shard;
+    }
+
+    this->shards.push_back(std::unique_ptr<MetricsShard>(new MetricsShard())); // Value-initialized : every counter starts at 0
+    return this->shards.back().get();
+}
+
+void Metrics::release_shard(MetricsShard *shard) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->freeShards.push_back(shard); // Its counts still belong to the totals
+}
@@ -0,0 +1,118 @@
+#include "MetricsServer.hpp"
+#include "Metrics.hpp"
+#include "SocketAddress.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    const int    POLL_INTERVAL_MS  = 100;  // How often the server checks whether it must stop
+    const size_t MAX_REQUEST_SIZE  = 4096; // Longer request headers are cut
+    const int    REQUEST_TIMEOUT_S = 1;    // A client slower than this is dropped
+
+    void send_all(int connection, const std::string &data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t chunk = ::send(connection, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (chunk < 0 && errno == EINTR) {
+                continue;
+            }
+            if (chunk <= 0) {
+                return; // Client gone
+            }
+            sent += static_cast<size_t>(chunk);
+        }
+    }
+}
+
+MetricsServer::MetricsServer(const std::string &address) : listener(-1), stopping(false) {
+    struct sockaddr_storage local;
+    socklen_t localSize = resolve_socket_address(address, "tcp", SOCK_STREAM, AF_UNSPEC, local);
+
+    this->listener = ::socket(local.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (this->listener < 0) {
+        throw std::runtime_error(std::string("Socket error : ") + std::strerror(errno));
+    }
+
+    int reuse = 1;
+    ::setsockopt(this->listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    if (local.ss_family == AF_UNIX) {
+        this->unixPath = reinterpret_cast<const struct sockaddr_un &>(local).sun_path;
+        ::unlink(this->unixPath.c_str()); // Left over by a previous run
+    }
+
+    if (::bind(this->listener, reinterpret_cast<const struct sockaddr *>(&local), localSize) != 0 || ::listen(this->listener, 16) != 0) {
+        std::string reason = std::strerror(errno);
+        ::close(this->listener);
+        throw std::runtime_error("Socket error : can't listen on `" + address + "` (" + reason + ")");
+    }
+
+    this->thread = std::thread(&MetricsServer::serve, this);
+}
+
+MetricsServer::~MetricsServer() {
+    this->stopping = true;
+    this->thread.join();
+
+    ::close(this->listener);
+    if (!this->unixPath.empty()) {
+        ::unlink(this->unixPath.c_str());
+    }
+}
+
+void MetricsServer::serve() {
+    while (!this->stopping) {
+        struct pollfd request;
+        request.fd      = this->listener;
+        request.events  = POLLIN;
+        request.revents = 0;
+
+        if (::poll(&request, 1, POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+
+        int connection = ::accept4(this->listener, NULL, NULL, SOCK_CLOEXEC);
+        if (connection < 0) {
+            continue;
+        }
+
+        this->answer(connection);
+        ::close(connection);
+    }
+}
+
+/// Reads the request line and headers, then sends the metrics (or a 404)
+void MetricsServer::answer(int connection) {
+    struct timeval timeout;
+    timeout.tv_sec  = REQUEST_TIMEOUT_S;
+    timeout.tv_usec = 0;
+    ::setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    char        buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_SIZE) {
+        ssize_t chunk = ::recv(connection, buffer, sizeof(buffer), 0);
+        if (chunk < 0 && errno == EINTR) {
+            continue;
+        }
+        if (chunk <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(chunk));
+    }
+
+    bool found = request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 6, "GET / ") == 0;
+
+    std::string body   = found ? Metrics::instance().render() : "Not found\n";
+    std::string status = found ? "200 OK" : "404 Not Found";
+
+    send_all(connection, "HTTP/1.0 " + status + "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                         "Content-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body);
+}
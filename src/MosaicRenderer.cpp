@@ -0,0 +1,186 @@
+#include "MosaicRenderer.hpp"
+#include "EmbeddedShaders.hpp"
+#include "ShaderProgram.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+#include <glm/gtc/type_ptr.hpp>
+
+MosaicRenderer::MosaicRenderer(size_t instanceCount, unsigned int columns) : instanceCount(instanceCount) {
+    if (instanceCount == 0) {
+        throw std::runtime_error("A mosaic needs at least one instance");
+    }
+
+    this->columns = columns > 0 ? columns : static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<double>(instanceCount))));
+    this->rows    = static_cast<unsigned int>((instanceCount + this->columns - 1) / this->columns);
+
+    float        squareVertices[] = {1.0f, 1.0f,    1.0f,  0.0f,    0.0f,  0.0f,    0.0f, 1.0f};
+    unsigned int squareIndices[]  = {0, 1, 3,    1, 2, 3};
+
+    glGenBuffers(1, &this->vboAddress);
+    glGenBuffers(1, &this->eboAddress);
+    glGenVertexArrays(1, &this->vaoAddress);
+
+    glBindVertexArray(this->vaoAddress);
+    glBindBuffer(GL_ARRAY_BUFFER,         this->vboAddress);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->eboAddress);
+
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(squareIndices), squareIndices, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(squareVertices), squareVertices, GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0); // Vertices
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2*sizeof(float), (void*)0);
+
+    glBindVertexArray(0); // Unbinding VAO first
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    this->pixelColor     = glm::vec4(1.0, 1.0, 1.0, 1.0);
+    this->programAddress = create_shader_program("mosaic", MOSAIC_VERTEX_SHADER, MOSAIC_FRAGMENT_SHADER);
+
+    glUseProgram(this->programAddress);
+
+    this->enabledColorUniformLocation = glGetUniformLocation(this->programAddress, "enabledColor");
+
+    glUniform4fv(this->enabledColorUniformLocation, 1, glm::value_ptr(this->pixelColor));
+    glUniform2i(glGetUniformLocation(this->programAddress, "mosaicSize"), this->columns, this->rows);
+    glUseProgram(0);
+
+    // Display state buffer : REGION_COUNT regions of `instanceCount` displays, written through a persistent mapping
+    GLint offsetAlignment = 1;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+
+    size_t regionBytes = DISPLAY_BYTES * instanceCount;
+    this->regionSize   = (regionBytes + offsetAlignment - 1) / offsetAlignment * offsetAlignment;
+
+    const GLbitfield mappingFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenBuffers(1, &this->displayBufferAddress);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->displayBufferAddress);
+    glBufferStorage(GL_SHADER_STORAGE_BUFFER, this->regionSize * REGION_COUNT, NULL, mappingFlags);
+
+    this->displayMapping = static_cast<uint8_t *>(glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, this->regionSize * REGION_COUNT, mappingFlags));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    if (this->displayMapping == NULL) {
+        this->delete_objects(); // The destructor won't run
+        throw std::runtime_error("OpenGL error : Failed to map the mosaic state buffer");
+    }
+
+    this->regionFences.fill(NULL);
+    for (size_t regionId = 0; regionId < REGION_COUNT; ++regionId) {
+        this->regionGenerations[regionId].assign(instanceCount, ~0ULL); // Nothing uploaded yet
+    }
+
+    this->currentRegion   = 0;
+    this->lastUploadCount = 0;
+}
+
+MosaicRenderer::~MosaicRenderer() {
+    for (size_t regionId = 0; regionId < REGION_COUNT; ++regionId) {
+        if (this->regionFences[regionId] != NULL) {
+            glDeleteSync(this->regionFences[regionId]);
+        }
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->displayBufferAddress);
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    this->delete_objects();
+}
+
+/// Deletes the buffers, VAO and program (the state buffer once unmapped)
+void MosaicRenderer::delete_objects() {
+    glDeleteBuffers(1, &this->displayBufferAddress);
+    glDeleteProgram(this->programAddress);
+    glDeleteVertexArrays(1, &this->vaoAddress);
+    glDeleteBuffers(1, &this->vboAddress);
+    glDeleteBuffers(1, &this->eboAddress);
+}
+
+/// Draws `get_instance_count()` displays, `views[i]` in the i-th tile (left to right, top to bottom)
+void MosaicRenderer::draw(const DisplayView *views) {
+    std::vector<uint64_t> &generations = this->regionGenerations[this->currentRegion];
+
+    // Stays on the current region when nothing changed, otherwise moves to the next one
+    bool changed = false;
+    for (size_t instance = 0; instance < this->instanceCount && !changed; ++instance) {
+        changed = views[instance].generation != generations[instance];
+    }
+
+    this->lastUploadCount = 0;
+
+    if (changed) {
+        this->currentRegion = (this->currentRegion + 1) % REGION_COUNT;
+
+        GLsync &fence = this->regionFences[this->currentRegion];
+        if (fence != NULL) {
+            GLenum status = glClientWaitSync(fence, 0, 0);
+            while (status == GL_TIMEOUT_EXPIRED) {
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            }
+
+            glDeleteSync(fence);
+            fence = NULL;
+        }
+
+        // The region may be a couple of frames behind : every display it doesn't hold yet is copied
+        std::vector<uint64_t> &uploaded = this->regionGenerations[this->currentRegion];
+        uint32_t *region = reinterpret_cast<uint32_t *>(this->displayMapping + this->currentRegion * this->regionSize);
+
+        for (size_t instance = 0; instance < this->instanceCount; ++instance) {
+            const DisplayView &view = views[instance];
+            if (view.generation == uploaded[instance]) {
+                continue;
+            }
+
+            uint32_t *words = region + instance * (DISPLAY_BYTES / 4);
+            for (unsigned int y = 0; y < DisplayView::HEIGHT; ++y) {
+                uint64_t row = view.row(y);
+                words[2*y]   = static_cast<uint32_t>(row >> 32);
+                words[2*y+1] = static_cast<uint32_t>(row);
+            }
+
+            uploaded[instance] = view.generation;
+            ++this->lastUploadCount;
+        }
+    }
+
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glBindVertexArray(this->vaoAddress);
+    glUseProgram(this->programAddress);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, this->displayBufferAddress, this->currentRegion * this->regionSize,
+                      DISPLAY_BYTES * this->instanceCount);
+
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(this->instanceCount)); // One instance per tile
+
+    // The region can't be written again before this draw (the last one reading it) is done
+    GLsync &fence = this->regionFences[this->currentRegion];
+    if (fence != NULL) {
+        glDeleteSync(fence);
+    }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
+
+size_t MosaicRenderer::get_instance_count() const {
+    return this->instanceCount;
+}
+
+unsigned int MosaicRenderer::get_columns() const {
+    return this->columns;
+}
+
+unsigned int MosaicRenderer::get_rows() const {
+    return this->rows;
+}
+
+size_t MosaicRenderer::get_last_upload_count() const {
+    return this->lastUploadCount;
+}
@@ -0,0 +1,187 @@
+#include "OffscreenContext.hpp"
+
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    bool has_extension(const char *extensions, const char *name) {
+        if (extensions == NULL) {
+            return false;
+        }
+
+        size_t nameLength = std::strlen(name);
+        for (const char *match = std::strstr(extensions, name); match != NULL; match = std::strstr(match + 1, name)) {
+            bool starts = match == extensions || match[-1] == ' ';
+            bool ends   = match[nameLength] == ' ' || match[nameLength] == '\0';
+            if (starts && ends) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    GLADapiproc load_egl_function(const char *name) {
+        return reinterpret_cast<GLADapiproc>(eglGetProcAddress(name));
+    }
+
+    EGLDisplay open_display() {
+        const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+        if (has_extension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+            PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+                reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+            if (getPlatformDisplay != NULL) {
+                EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+                if (display != EGL_NO_DISPLAY) {
+                    return display;
+                }
+            }
+        }
+
+        return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+}
+
+OffscreenContext::OffscreenContext(unsigned int width, unsigned int height) : eglDisplay(EGL_NO_DISPLAY),
+                                                                              eglContext(EGL_NO_CONTEXT),
+                                                                              eglSurface(EGL_NO_SURFACE),
+                                                                              framebufferAddress(0),
+                                                                              renderbufferAddress(0),
+                                                                              width(width), height(height) {
+    EGLDisplay display = open_display();
+    EGLint major = 0, minor = 0;
+
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        throw std::runtime_error("EGL error : No display available for offscreen rendering");
+    }
+    this->eglDisplay = display;
+
+    bool surfaceless = has_extension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+
+    const EGLint configAttributes[] = {EGL_SURFACE_TYPE,    surfaceless ? 0 : EGL_PBUFFER_BIT,
+                                       EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                       EGL_RED_SIZE,   8, EGL_GREEN_SIZE, 8,
+                                       EGL_BLUE_SIZE,  8, EGL_ALPHA_SIZE, 8,
+                                       EGL_NONE};
+    EGLConfig config;
+    EGLint configCount = 0;
+
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+        this->release(); // The destructor won't run
+        throw std::runtime_error("EGL error : No OpenGL-renderable configuration");
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        this->release();
+        throw std::runtime_error("EGL error : Desktop OpenGL is not supported");
+    }
+
+    const EGLint contextAttributes[] = {EGL_CONTEXT_MAJOR_VERSION,       4,
+                                        EGL_CONTEXT_MINOR_VERSION,       4,
+                                        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                                        EGL_NONE};
+
+    this->eglContext = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (this->eglContext == EGL_NO_CONTEXT) {
+        this->release();
+        throw std::runtime_error("EGL error : Failed to create an OpenGL 4.4 core context");
+    }
+
+    if (!surfaceless) {
+        const EGLint surfaceAttributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+        this->eglSurface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+        if (this->eglSurface == EGL_NO_SURFACE) {
+            this->release();
+            throw std::runtime_error("EGL error : Failed to create a pbuffer surface");
+        }
+    }
+
+    if (!eglMakeCurrent(display, this->eglSurface, this->eglSurface, this->eglContext)) {
+        this->release();
+        throw std::runtime_error("EGL error : Failed to make the offscreen context current");
+    }
+
+    if (gladLoadGL(load_egl_function) == 0) {
+        this->release();
+        throw std::runtime_error("OpenGL error : Failed to load functions for the offscreen context");
+    }
+
+    // Render target
+    glGenFramebuffers(1, &this->framebufferAddress);
+    glGenRenderbuffers(1, &this->renderbufferAddress);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, this->renderbufferAddress);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, this->width, this->height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferAddress);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->renderbufferAddress);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        this->release();
+        throw std::runtime_error("OpenGL error : Incomplete offscreen framebuffer");
+    }
+
+    glViewport(0, 0, this->width, this->height);
+}
+
+OffscreenContext::~OffscreenContext() {
+    this->release();
+}
+
+/// Deletes whatever was created so far : GL objects (only generated once GL is loaded), context, surface and display
+void OffscreenContext::release() {
+    if (this->framebufferAddress != 0 || this->renderbufferAddress != 0) {
+        this->make_current();
+
+        glDeleteFramebuffers(1, &this->framebufferAddress);
+        glDeleteRenderbuffers(1, &this->renderbufferAddress);
+    }
+
+    eglMakeCurrent(this->eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (this->eglSurface != EGL_NO_SURFACE) {
+        eglDestroySurface(this->eglDisplay, this->eglSurface);
+    }
+    if (this->eglContext != EGL_NO_CONTEXT) {
+        eglDestroyContext(this->eglDisplay, this->eglContext);
+    }
+    eglTerminate(this->eglDisplay);
+}
+
+void OffscreenContext::make_current() {
+    eglMakeCurrent(this->eglDisplay, this->eglSurface, this->eglSurface, this->eglContext);
+    glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferAddress);
+}
+
+/// Blocking readback of the whole render target (`get_frame_size()` bytes, bottom row first)
+void OffscreenContext::read_pixels(uint8_t *rgba) {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, this->framebufferAddress);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, this->width, this->height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+}
+
+unsigned int OffscreenContext::get_width() const {
+    return this->width;
+}
+
+unsigned int OffscreenContext::get_height() const {
+    return this->height;
+}
+
+size_t OffscreenContext::get_frame_size() const {
+    return static_cast<size_t>(this->width) * this->height * 4;
+}
+
+GLuint OffscreenContext::get_framebuffer() const {
+    return this->framebufferAddress;
+}
+
+const char *OffscreenContext::get_renderer_name() const {
+    return reinterpret_cast<const char *>(glGetString(GL_RENDERER));
+}
@@ -0,0 +1,111 @@
+#include "PerfCounterGroup.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+const char *const PerfCounterGroup::COUNTER_NAMES[PerfCounterGroup::COUNTER_COUNT] = {
+    "cycles", "instructions", "branch-misses", "L1d-misses"
+};
+
+#ifdef __linux__
+
+namespace {
+    int open_counter(uint32_t type, uint64_t config, int groupLeader) {
+        struct perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size           = sizeof(attributes);
+        attributes.type           = type;
+        attributes.config         = config;
+        attributes.disabled       = groupLeader < 0 ? 1 : 0; // The leader starts and stops the whole group
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv     = 1;
+        attributes.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attributes, 0, -1, groupLeader, 0)); // This thread, any CPU
+    }
+}
+
+PerfCounterGroup::PerfCounterGroup() : openCounters(0) {
+    this->fileDescriptors.fill(-1);
+
+    const uint32_t types[COUNTER_COUNT]   = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE};
+    const uint64_t configs[COUNTER_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+    };
+
+    for (size_t counter = 0; counter < COUNTER_COUNT; ++counter) {
+        int fileDescriptor = open_counter(types[counter], configs[counter], this->fileDescriptors[CYCLES]);
+
+        if (fileDescriptor < 0 && counter == CYCLES) {
+            throw std::runtime_error(std::string("Perf error : can't open the cycle counter (") + std::strerror(errno) + ")");
+        }
+        if (fileDescriptor >= 0) {
+            this->fileDescriptors[counter] = fileDescriptor;
+            ++this->openCounters;
+        }
+    }
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+    for (size_t counter = 0; counter < COUNTER_COUNT; ++counter) {
+        if (this->fileDescriptors[counter] >= 0) {
+            ::close(this->fileDescriptors[counter]);
+        }
+    }
+}
+
+void PerfCounterGroup::start() {
+    ::ioctl(this->fileDescriptors[CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(this->fileDescriptors[CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounts PerfCounterGroup::stop() {
+    ::ioctl(this->fileDescriptors[CYCLES], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // PERF_FORMAT_GROUP layout : counter count, time enabled, time running, then the values in opening order
+    std::vector<uint64_t> data(3 + this->openCounters, 0);
+    ssize_t size = ::read(this->fileDescriptors[CYCLES], data.data(), data.size() * sizeof(uint64_t));
+    if (size < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+        throw std::runtime_error(std::string("Perf error : can't read the counters (") + std::strerror(errno) + ")");
+    }
+
+    // The kernel only counted while the group was scheduled on the PMU : extrapolates to the whole run
+    double scale = data[2] > 0 ? static_cast<double>(data[1]) / static_cast<double>(data[2]) : 0.0;
+
+    PerfCounts counts;
+    size_t     valueId = 3;
+    for (size_t counter = 0; counter < COUNTER_COUNT; ++counter) {
+        counts.available[counter] = this->fileDescriptors[counter] >= 0;
+        counts.values[counter]    = counts.available[counter] ? scale * static_cast<double>(data[valueId++]) : 0.0;
+    }
+    return counts;
+}
+
+#else
+
+PerfCounterGroup::PerfCounterGroup() : openCounters(0) {
+    this->fileDescriptors.fill(-1);
+    throw std::runtime_error("Perf error : hardware counters need Linux perf_event_open");
+}
+
+PerfCounterGroup::~PerfCounterGroup() {}
+
+void PerfCounterGroup::start() {}
+
+PerfCounts PerfCounterGroup::stop() {
+    return PerfCounts();
+}
+
+#endif
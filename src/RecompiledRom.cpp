@@ -0,0 +1,47 @@
+#include "RecompiledRom.hpp"
+#include "Hash.hpp"
+
+#include <cstring>
+#include <dlfcn.h>
+#include <stdexcept>
+
+RecompiledRomRegistry::RecompiledRomRegistry() {}
+
+RecompiledRomRegistry &RecompiledRomRegistry::instance() {
+    static RecompiledRomRegistry registry;
+    return registry;
+}
+
+void RecompiledRomRegistry::add(const RecompiledRom *rom) {
+    uint64_t hash = xxhash64(rom->image, rom->imageSize);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->byHash[hash].push_back(rom);
+}
+
+/// Recompiled version of the given program, NULL if there is none
+const RecompiledRom *RecompiledRomRegistry::find(const uint8_t *program, size_t programSize) {
+    uint64_t hash = xxhash64(program, programSize);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    std::unordered_map<uint64_t, std::vector<const RecompiledRom *>>::const_iterator entry = this->byHash.find(hash);
+    if (entry == this->byHash.end()) {
+        return NULL;
+    }
+
+    for (size_t romId = 0; romId < entry->second.size(); ++romId) {
+        const RecompiledRom *rom = entry->second[romId];
+        if (rom->imageSize == programSize && std::memcmp(rom->image, program, programSize) == 0) {
+            return rom;
+        }
+    }
+    return NULL;
+}
+
+/// Loads a shared library built from generated units; they register themselves while it is opened
+void RecompiledRomRegistry::load_plugin(const std::string &fileName) {
+    if (::dlopen(fileName.c_str(), RTLD_NOW | RTLD_LOCAL) == NULL) { // Never closed : its ROMs stay registered
+        throw std::runtime_error("Recompiled ROM plugin error : " + std::string(::dlerror()));
+    }
+}
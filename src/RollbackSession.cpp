@@ -0,0 +1,260 @@
+#include "RollbackSession.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+// Packet layout (little-endian) :
+//   u32 magic "C8RB" | i32 last remote frame received | i32 hashed frame | u64 its state hash
+//   | i32 first input frame | u8 input count | u16 inputs...
+
+namespace {
+    const uint32_t PACKET_MAGIC       = 0x42523843; // "C8RB"
+    const size_t   PACKET_HEADER_SIZE = 4 + 3*4 + 8 + 1;
+
+    void write_u16(uint8_t *&cursor, uint16_t value) {
+        *cursor++ = static_cast<uint8_t>(value);
+        *cursor++ = static_cast<uint8_t>(value >> 8);
+    }
+
+    void write_u32(uint8_t *&cursor, uint32_t value) {
+        write_u16(cursor, static_cast<uint16_t>(value));
+        write_u16(cursor, static_cast<uint16_t>(value >> 16));
+    }
+
+    void write_u64(uint8_t *&cursor, uint64_t value) {
+        write_u32(cursor, static_cast<uint32_t>(value));
+        write_u32(cursor, static_cast<uint32_t>(value >> 32));
+    }
+
+    uint16_t read_u16(const uint8_t *&cursor) {
+        uint16_t value = static_cast<uint16_t>(cursor[0] | cursor[1] << 8);
+        cursor += 2;
+        return value;
+    }
+
+    uint32_t read_u32(const uint8_t *&cursor) {
+        uint32_t low = read_u16(cursor);
+        return low | static_cast<uint32_t>(read_u16(cursor)) << 16;
+    }
+
+    uint64_t read_u64(const uint8_t *&cursor) {
+        uint64_t low = read_u32(cursor);
+        return low | static_cast<uint64_t>(read_u32(cursor)) << 32;
+    }
+}
+
+/// Both peers must start from identical cores : same program, same random seed
+RollbackSession::RollbackSession(const Chip8 &initial, unsigned int maxRollback) : core(initial.fork()),
+                                                                                    snapshots(HISTORY_SIZE),
+                                                                                    localInputs(HISTORY_SIZE, 0),
+                                                                                    remoteInputs(HISTORY_SIZE, 0),
+                                                                                    stateHashes(HISTORY_SIZE, 0),
+                                                                                    maxRollback(maxRollback),
+                                                                                    frame(0),
+                                                                                    remoteConfirmed(-1),
+                                                                                    remoteAck(-1),
+                                                                                    hashedFrame(-1),
+                                                                                    mispredicted(-1),
+                                                                                    remoteHashFrame(-1),
+                                                                                    remoteHash(0),
+                                                                                    desyncFrame(-1),
+                                                                                    rollbacks(0),
+                                                                                    resimulatedFrames(0) {
+    if (maxRollback == 0 || maxRollback > MAX_ROLLBACK) {
+        throw std::runtime_error("Rollback error : the window must be 1 to " + std::to_string(MAX_ROLLBACK) + " frames long");
+    }
+
+    this->hash_confirmed_frames(); // Nothing comes before frame 0
+}
+
+/// Runs the next frame with `localInput` held, or returns false when too far ahead of the peer
+bool RollbackSession::advance(uint16_t localInput) {
+    if (this->mispredicted >= 0) {
+        this->roll_back();
+    }
+
+    if (this->frame - this->remoteConfirmed > this->maxRollback || this->frame - this->remoteAck > MAX_INPUTS) {
+        return false;
+    }
+
+    size_t frameSlot = RollbackSession::slot(this->frame);
+    this->localInputs[frameSlot] = localInput;
+    if (this->frame > this->remoteConfirmed) { // The remote player keeps the keys of their last known input
+        this->remoteInputs[frameSlot] = this->remoteConfirmed >= 0 ? this->remoteInputs[RollbackSession::slot(this->remoteConfirmed)] : 0;
+    }
+
+    this->simulate_frame();
+    this->hash_confirmed_frames();
+    return true;
+}
+
+/// Writes the local inputs the peer lacks into `packet` (`MAX_PACKET_SIZE` bytes) and returns its size
+size_t RollbackSession::write_packet(uint8_t *packet) const {
+    int64_t      firstFrame = this->remoteAck + 1;
+    unsigned int inputCount = static_cast<unsigned int>(std::min<int64_t>(std::max<int64_t>(this->frame - firstFrame, 0), MAX_INPUTS));
+
+    uint8_t *cursor = packet;
+    write_u32(cursor, PACKET_MAGIC);
+    write_u32(cursor, static_cast<uint32_t>(this->remoteConfirmed));
+    write_u32(cursor, static_cast<uint32_t>(this->hashedFrame));
+    write_u64(cursor, this->hashedFrame >= 0 ? this->stateHashes[RollbackSession::slot(this->hashedFrame)] : 0);
+    write_u32(cursor, static_cast<uint32_t>(firstFrame));
+    *cursor++ = static_cast<uint8_t>(inputCount);
+
+    for (unsigned int inputId = 0; inputId < inputCount; ++inputId) {
+        write_u16(cursor, this->localInputs[RollbackSession::slot(firstFrame + inputId)]);
+    }
+    return static_cast<size_t>(cursor - packet);
+}
+
+/// Takes in a packet of the peer; returns false (and ignores it) when it isn't one
+bool RollbackSession::read_packet(const uint8_t *packet, size_t size) {
+    if (size < PACKET_HEADER_SIZE) {
+        return false;
+    }
+
+    const uint8_t *cursor = packet;
+    if (read_u32(cursor) != PACKET_MAGIC) {
+        return false;
+    }
+
+    int64_t      ackFrame   = static_cast<int32_t>(read_u32(cursor));
+    int64_t      hashFrame  = static_cast<int32_t>(read_u32(cursor));
+    uint64_t     hash       = read_u64(cursor);
+    int64_t      firstFrame = static_cast<int32_t>(read_u32(cursor));
+    unsigned int inputCount = *cursor++;
+
+    if (inputCount > MAX_INPUTS || size != PACKET_HEADER_SIZE + 2*inputCount) {
+        return false;
+    }
+
+    this->remoteAck = std::max(this->remoteAck, std::min(ackFrame, this->frame - 1));
+    if (hashFrame > this->remoteHashFrame) {
+        this->remoteHashFrame = hashFrame;
+        this->remoteHash      = hash;
+    }
+
+    for (unsigned int inputId = 0; inputId < inputCount; ++inputId) {
+        int64_t  inputFrame = firstFrame + inputId;
+        uint16_t input      = read_u16(cursor);
+
+        if (inputFrame != this->remoteConfirmed + 1 || inputFrame >= this->frame + MAX_INPUTS) {
+            continue; // Already known, after a gap (a packet was lost) or further than the peer can be
+        }
+
+        size_t inputSlot = RollbackSession::slot(inputFrame);
+        if (inputFrame < this->frame && this->remoteInputs[inputSlot] != input && this->mispredicted < 0) {
+            this->mispredicted = inputFrame; // Frames come in order : the first one is the earliest
+        }
+        this->remoteInputs[inputSlot] = input;
+        this->remoteConfirmed         = inputFrame;
+    }
+
+    this->hash_confirmed_frames();
+    return true;
+}
+
+const Chip8 &RollbackSession::get_core() const {
+    return *this->core;
+}
+
+int64_t RollbackSession::get_frame() const {
+    return this->frame;
+}
+
+int64_t RollbackSession::get_confirmed_frame() const {
+    return this->remoteConfirmed;
+}
+
+int64_t RollbackSession::get_acknowledged_frame() const {
+    return this->remoteAck;
+}
+
+int64_t RollbackSession::get_hashed_frame() const {
+    return this->hashedFrame;
+}
+
+/// State hash at the start of `frame`, once all the inputs before it are confirmed
+uint64_t RollbackSession::get_hash(int64_t frame) const {
+    if (frame < 0 || frame > this->hashedFrame || this->hashedFrame - frame >= HISTORY_SIZE) {
+        throw std::runtime_error("Rollback error : no state hash for frame " + std::to_string(frame));
+    }
+    return this->stateHashes[RollbackSession::slot(frame)];
+}
+
+int64_t RollbackSession::get_remote_hash_frame() const {
+    return this->remoteHashFrame;
+}
+
+int64_t RollbackSession::get_desync_frame() const {
+    return this->desyncFrame;
+}
+
+uint64_t RollbackSession::get_rollbacks() const {
+    return this->rollbacks;
+}
+
+uint64_t RollbackSession::get_resimulated_frames() const {
+    return this->resimulatedFrames;
+}
+
+/// Snapshots the core, then runs frame `frame` with the inputs recorded for it
+void RollbackSession::simulate_frame() {
+    size_t frameSlot = RollbackSession::slot(this->frame);
+
+    this->snapshots[frameSlot] = this->core->fork();
+    this->core->set_keypad_state(this->localInputs[frameSlot] | this->remoteInputs[frameSlot]);
+    this->core->run_frames(1);
+    ++this->frame;
+}
+
+/// Restores the start of the first mispredicted frame and runs the frames since with the inputs known now
+void RollbackSession::roll_back() {
+    int64_t lastFrame = this->frame;
+
+    this->frame = this->mispredicted;
+    this->core  = std::move(this->snapshots[RollbackSession::slot(this->frame)]); // Forked again by `simulate_frame()`
+
+    while (this->frame < lastFrame) {
+        if (this->frame > this->remoteConfirmed) {
+            this->remoteInputs[RollbackSession::slot(this->frame)] = this->remoteInputs[RollbackSession::slot(this->remoteConfirmed)];
+        }
+        this->simulate_frame();
+    }
+
+    ++this->rollbacks;
+    this->resimulatedFrames += static_cast<uint64_t>(lastFrame - this->mispredicted);
+    this->mispredicted       = -1;
+}
+
+/// Hashes the frames whose starting state can't change anymore : every input before them is confirmed
+void RollbackSession::hash_confirmed_frames() {
+    int64_t lastFinal = std::min(this->remoteConfirmed + 1, this->frame);
+    if (this->mispredicted >= 0) {
+        lastFinal = std::min(lastFinal, this->mispredicted);
+    }
+
+    for (int64_t hashFrame = this->hashedFrame + 1; hashFrame <= lastFinal; ++hashFrame) {
+        const Chip8 &state = hashFrame == this->frame ? *this->core : *this->snapshots[RollbackSession::slot(hashFrame)];
+        this->stateHashes[RollbackSession::slot(hashFrame)] = state.get_state_hash();
+        this->hashedFrame = hashFrame;
+    }
+
+    this->check_remote_hash();
+}
+
+void RollbackSession::check_remote_hash() {
+    if (this->desyncFrame >= 0 || this->remoteHashFrame < 0 || this->remoteHashFrame > this->hashedFrame
+        || this->hashedFrame - this->remoteHashFrame >= HISTORY_SIZE) {
+        return;
+    }
+
+    if (this->stateHashes[RollbackSession::slot(this->remoteHashFrame)] != this->remoteHash) {
+        this->desyncFrame = this->remoteHashFrame;
+    }
+}
+
+size_t RollbackSession::slot(int64_t frame) {
+    return static_cast<size_t>(frame) % HISTORY_SIZE;
+}
@@ -0,0 +1,128 @@
+#include "RomCache.hpp"
+#include "Hash.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const off_t MAX_PROGRAM_SIZE = 4096-512; // Programs are loaded at 0x200
+
+    int64_t modification_time_of(const struct stat &status) {
+        return static_cast<int64_t>(status.st_mtim.tv_sec) * 1000000000 + status.st_mtim.tv_nsec;
+    }
+}
+
+RomCache::RomCache() {}
+
+RomCache &RomCache::instance() {
+    static RomCache cache;
+    return cache;
+}
+
+std::shared_ptr<const RomImage> RomCache::load(const std::string &fileName) {
+    struct stat status;
+    if (::stat(fileName.c_str(), &status) != 0 || !S_ISREG(status.st_mode)) {
+        throw std::runtime_error("Program file not found : `" + fileName + "`");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        std::map<std::string, FileEntry>::const_iterator entry = this->byPath.find(fileName);
+        if (entry != this->byPath.end()
+            && entry->second.device           == status.st_dev
+            && entry->second.inode            == status.st_ino
+            && entry->second.size             == status.st_size
+            && entry->second.modificationTime == modification_time_of(status)) {
+            return entry->second.image; // Unchanged file : no I/O at all
+        }
+    }
+
+    if (status.st_size > MAX_PROGRAM_SIZE) {
+        throw std::runtime_error("Program is too big to fit in the memory (" + std::to_string(status.st_size) + " bytes)");
+    }
+
+    int fileDescriptor = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fileDescriptor < 0) {
+        throw std::runtime_error("Program file not found : `" + fileName + "`");
+    }
+
+    // One byte more than allowed, so a file that grew since `stat()` is still caught
+    std::vector<uint8_t> bytes(MAX_PROGRAM_SIZE + 1);
+    size_t readSize = 0;
+
+    while (readSize < bytes.size()) {
+        ssize_t chunk = ::read(fileDescriptor, bytes.data() + readSize, bytes.size() - readSize);
+        if (chunk < 0 && errno == EINTR) {
+            continue;
+        }
+        if (chunk <= 0) {
+            break;
+        }
+        readSize += static_cast<size_t>(chunk);
+    }
+
+    ::close(fileDescriptor);
+
+    if (readSize > static_cast<size_t>(MAX_PROGRAM_SIZE)) {
+        throw std::runtime_error("Program is too big to fit in the memory (" + std::to_string(readSize) + " bytes)");
+    }
+    bytes.resize(readSize);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    FileEntry entry;
+    entry.device           = status.st_dev;
+    entry.inode            = status.st_ino;
+    entry.size             = static_cast<off_t>(readSize);
+    entry.modificationTime = modification_time_of(status);
+    entry.image            = this->intern_locked(std::move(bytes));
+
+    this->byPath[fileName] = entry;
+
+    return entry.image;
+}
+
+std::shared_ptr<const RomImage> RomCache::intern(const uint8_t *bytes, size_t size) {
+    std::vector<uint8_t> content(bytes, bytes + size);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->intern_locked(std::move(content));
+}
+
+std::shared_ptr<const LoadedProgram> RomCache::get_loaded_program(const RomImage &image) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return image.loaded;
+}
+
+void RomCache::set_loaded_program(const RomImage &image, const std::shared_ptr<const LoadedProgram> &loaded) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    image.loaded = loaded;
+}
+
+void RomCache::clear() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    this->byPath.clear();
+    this->byContent.clear();
+}
+
+std::shared_ptr<const RomImage> RomCache::intern_locked(std::vector<uint8_t> &&bytes) {
+    uint64_t hash = xxhash64(bytes.data(), bytes.size());
+
+    std::unordered_map<uint64_t, std::shared_ptr<const RomImage>>::const_iterator known = this->byContent.find(hash);
+    if (known != this->byContent.end() && known->second->bytes == bytes) {
+        return known->second;
+    }
+
+    std::shared_ptr<RomImage> image = std::make_shared<RomImage>();
+    image->hash  = hash;
+    image->bytes = std::move(bytes);
+
+    this->byContent[hash] = image;
+
+    return image;
+}
@@ -0,0 +1,495 @@
+#include "RomCorpus.hpp"
+#include "Hash.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+    const char     CORPUS_MAGIC[8] = {'C', '8', 'C', 'O', 'R', 'P', 'U', 'S'};
+    const uint32_t CORPUS_VERSION  = 1;
+    const size_t   MAX_ROM_SIZE    = 65536; // XO-CHIP address space
+    const size_t   MAX_CHIP8_SIZE  = 4096-512;
+
+    struct ScannedRom {
+        std::string          path;  ///< Source file
+        std::string          title; ///< File name without extension
+        std::vector<uint8_t> bytes; ///< Content (empty if unreadable)
+        uint64_t             hash;  ///< XXH64 of the content
+        bool                 valid; ///< Whether the file could be read
+    };
+
+    size_t align8(size_t offset) {
+        return (offset + 7) & ~static_cast<size_t>(7);
+    }
+
+    bool has_suffix(const std::string &text, const std::string &suffix) {
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    void collect_roms(const std::string &directory, std::vector<std::string> &paths) {
+        DIR *handle = ::opendir(directory.c_str());
+        if (handle == NULL) {
+            throw std::runtime_error("Could not open ROM directory : `" + directory + "`");
+        }
+
+        while (struct dirent *item = ::readdir(handle)) {
+            std::string name = item->d_name;
+            if (name == "." || name == "..") {
+                continue;
+            }
+
+            std::string path = directory + "/" + name;
+
+            struct stat status;
+            if (::stat(path.c_str(), &status) != 0) {
+                continue;
+            }
+
+            if (S_ISDIR(status.st_mode)) {
+                collect_roms(path, paths);
+            } else if (S_ISREG(status.st_mode) && has_suffix(name, ".ch8")) {
+                paths.push_back(path);
+            }
+        }
+
+        ::closedir(handle);
+    }
+
+    void read_rom(ScannedRom &rom) {
+        rom.valid = false;
+
+        int fileDescriptor = ::open(rom.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fileDescriptor < 0) {
+            return;
+        }
+
+        rom.bytes.resize(MAX_ROM_SIZE + 1);
+        size_t readSize = 0;
+
+        while (readSize < rom.bytes.size()) {
+            ssize_t chunk = ::read(fileDescriptor, rom.bytes.data() + readSize, rom.bytes.size() - readSize);
+            if (chunk < 0 && errno == EINTR) {
+                continue;
+            }
+            if (chunk <= 0) {
+                break;
+            }
+            readSize += static_cast<size_t>(chunk);
+        }
+
+        ::close(fileDescriptor);
+
+        if (readSize == 0 || readSize > MAX_ROM_SIZE) {
+            rom.bytes.clear();
+            return;
+        }
+
+        rom.bytes.resize(readSize);
+        rom.hash  = xxhash64(rom.bytes.data(), rom.bytes.size());
+        rom.valid = true;
+
+        size_t nameStart = rom.path.find_last_of('/');
+        rom.title = rom.path.substr(nameStart == std::string::npos ? 0 : nameStart + 1);
+        rom.title = rom.title.substr(0, rom.title.size() - 4); // Drops `.ch8`
+    }
+
+    // Marks the instructions reachable from 0x200 by following jumps, calls and both sides of skips, so
+    // that sprite data isn't mistaken for code. BNNN targets are unknown and end the path.
+    std::vector<uint16_t> collect_reachable_instructions(const uint8_t *bytes, size_t size) {
+        std::vector<bool>     visited(size, false);
+        std::vector<size_t>   pending(1, 0);
+        std::vector<uint16_t> instructions;
+
+        while (!pending.empty()) {
+            size_t offset = pending.back();
+            pending.pop_back();
+
+            while (offset + 1 < size && !visited[offset]) {
+                visited[offset] = true;
+
+                uint16_t instruction = static_cast<uint16_t>(bytes[offset] << 8 | bytes[offset+1]);
+                uint16_t address     = instruction & 0xFFF;
+                instructions.push_back(instruction);
+
+                size_t next = offset + (instruction == 0xF000 ? 4 : 2); // XO-CHIP long I carries its address
+
+                if (instruction == 0x00EE || instruction == 0x00FD || (instruction >> 12) == 0xB) {
+                    break;
+                } else if ((instruction >> 12) == 0x1) {
+                    next = address - 0x200;
+                    if (address < 0x200) {
+                        break;
+                    }
+                } else if ((instruction >> 12) == 0x2) {
+                    if (address >= 0x200) {
+                        pending.push_back(address - 0x200);
+                    }
+                } else if ((instruction >> 12) == 0x3 || (instruction >> 12) == 0x4
+                        || (instruction & 0xF00F) == 0x5000 || (instruction & 0xF00F) == 0x9000
+                        || (instruction & 0xF0FF) == 0xE09E || (instruction & 0xF0FF) == 0xE0A1) {
+                    pending.push_back(next + 2); // Skipped path
+                }
+
+                offset = next;
+            }
+        }
+
+        return instructions;
+    }
+
+    int compare_titles(const char *left, size_t leftLength, const char *right, size_t rightLength) {
+        int order = std::memcmp(left, right, std::min(leftLength, rightLength));
+        if (order != 0) {
+            return order;
+        }
+        return leftLength < rightLength ? -1 : (leftLength > rightLength ? 1 : 0);
+    }
+}
+
+RomCorpus::RomCorpus(const std::string &fileName) : fileName(fileName), mapping(NULL), mappingSize(0),
+                                                    header(NULL),       entries(NULL), titleIndex(NULL),
+                                                    titles(NULL) {
+    int fileDescriptor = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fileDescriptor < 0) {
+        throw std::runtime_error("Corpus file not found : `" + fileName + "`");
+    }
+
+    struct stat status;
+    if (::fstat(fileDescriptor, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(CorpusHeader))) {
+        ::close(fileDescriptor);
+        throw std::runtime_error("Corpus file is truncated : `" + fileName + "`");
+    }
+
+    this->mappingSize = static_cast<size_t>(status.st_size);
+    void *mapped = ::mmap(NULL, this->mappingSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    ::close(fileDescriptor); // The mapping keeps the file alive
+
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Could not map corpus file : `" + fileName + "`");
+    }
+    this->mapping = static_cast<const uint8_t *>(mapped);
+
+    this->header = reinterpret_cast<const CorpusHeader *>(this->mapping);
+
+    const CorpusHeader &head = *this->header;
+    bool valid = std::memcmp(head.magic, CORPUS_MAGIC, sizeof(CORPUS_MAGIC)) == 0
+              && head.version  == CORPUS_VERSION
+              && head.fileSize == this->mappingSize
+              && head.entriesOffset    <= head.titleIndexOffset // Ordered sections : the differences below can't wrap around
+              && head.titleIndexOffset <= head.titlesOffset
+              && head.titlesOffset     <= head.blobsOffset
+              && head.blobsOffset      <= this->mappingSize
+              && head.entriesOffset    % alignof(CorpusEntry) == 0
+              && head.titleIndexOffset % alignof(uint32_t) == 0
+              && head.entryCount <= (head.titleIndexOffset - head.entriesOffset) / sizeof(CorpusEntry)
+              && head.entryCount <= (head.titlesOffset - head.titleIndexOffset) / sizeof(uint32_t);
+
+    if (!valid) {
+        ::munmap(mapped, this->mappingSize);
+        throw std::runtime_error("Invalid or unsupported corpus file : `" + fileName + "`");
+    }
+
+    this->entries    = reinterpret_cast<const CorpusEntry *>(this->mapping + head.entriesOffset);
+    this->titleIndex = reinterpret_cast<const uint32_t *>(this->mapping + head.titleIndexOffset);
+    this->titles     = reinterpret_cast<const char *>(this->mapping + head.titlesOffset);
+
+    // Lookups index the entries and titles straight from the file : every reference is checked once here
+    uint64_t titlesSize = head.blobsOffset - head.titlesOffset;
+    for (uint32_t entryId = 0; entryId < head.entryCount; ++entryId) {
+        const CorpusEntry &entry = this->entries[entryId];
+
+        bool entryValid = this->titleIndex[entryId] < head.entryCount
+                       && static_cast<uint64_t>(entry.titleOffset) + entry.titleLength <= titlesSize
+                       && entry.blobOffset <= this->mappingSize
+                       && entry.size <= this->mappingSize - entry.blobOffset;
+
+        if (!entryValid) {
+            ::munmap(mapped, this->mappingSize);
+            throw std::runtime_error("Corrupted corpus entry in `" + fileName + "`");
+        }
+    }
+}
+
+RomCorpus::~RomCorpus() {
+    ::munmap(const_cast<uint8_t *>(this->mapping), this->mappingSize);
+}
+
+size_t RomCorpus::size() const {
+    return this->header->entryCount;
+}
+
+CorpusRom RomCorpus::at(size_t entryId) const {
+    const CorpusEntry &entry = this->entries[entryId];
+
+    if (entry.blobOffset + entry.size > this->mappingSize) {
+        throw std::runtime_error("Corrupted corpus entry in `" + this->fileName + "`");
+    }
+
+    CorpusRom rom;
+    rom.entry = &entry;
+    rom.bytes = this->mapping + entry.blobOffset;
+    rom.title = this->title_of(entry);
+    return rom;
+}
+
+bool RomCorpus::find(uint64_t hash, CorpusRom &rom) const {
+    const CorpusEntry *end   = this->entries + this->size();
+    const CorpusEntry *found = std::lower_bound(this->entries, end, hash, [](const CorpusEntry &entry, uint64_t value) {
+        return entry.hash < value;
+    });
+
+    if (found == end || found->hash != hash) {
+        return false;
+    }
+
+    rom = this->at(static_cast<size_t>(found - this->entries));
+    return true;
+}
+
+bool RomCorpus::find(const std::string &title, CorpusRom &rom) const {
+    const uint32_t *end   = this->titleIndex + this->size();
+    const uint32_t *found = std::lower_bound(this->titleIndex, end, title, [this](uint32_t entryId, const std::string &value) {
+        const CorpusEntry &entry = this->entries[entryId];
+        return compare_titles(this->titles + entry.titleOffset, entry.titleLength, value.data(), value.size()) < 0;
+    });
+
+    if (found == end) {
+        return false;
+    }
+
+    const CorpusEntry &entry = this->entries[*found];
+    if (compare_titles(this->titles + entry.titleOffset, entry.titleLength, title.data(), title.size()) != 0) {
+        return false;
+    }
+
+    rom = this->at(*found);
+    return true;
+}
+
+bool RomCorpus::find_any(const std::string &titleOrHash, CorpusRom &rom) const {
+    if (titleOrHash.size() == 16 && titleOrHash.find_first_not_of("0123456789abcdefABCDEF") == std::string::npos) {
+        if (this->find(std::strtoull(titleOrHash.c_str(), NULL, 16), rom)) {
+            return true;
+        }
+    }
+
+    return this->find(titleOrHash, rom);
+}
+
+std::string RomCorpus::title_of(const CorpusEntry &entry) const {
+    return std::string(this->titles + entry.titleOffset, entry.titleLength);
+}
+
+size_t build_rom_corpus(const std::string &directory, const std::string &outputFileName, unsigned int threadCount) {
+    std::vector<std::string> paths;
+    collect_roms(directory, paths);
+    std::sort(paths.begin(), paths.end()); // Deterministic output, whatever the readdir order
+
+    std::vector<ScannedRom> roms(paths.size());
+    for (size_t romId = 0; romId < paths.size(); ++romId) {
+        roms[romId].path = paths[romId];
+    }
+
+    // Reading, hashing and detection are spread across the workers
+    std::atomic<size_t> nextRom(0);
+    std::vector<std::thread> workers;
+    threadCount = std::max(1u, threadCount);
+
+    for (unsigned int workerId = 0; workerId < threadCount; ++workerId) {
+        workers.push_back(std::thread([&roms, &nextRom]() {
+            for (size_t romId = nextRom++; romId < roms.size(); romId = nextRom++) {
+                read_rom(roms[romId]);
+            }
+        }));
+    }
+
+    for (size_t workerId = 0; workerId < workers.size(); ++workerId) {
+        workers[workerId].join();
+    }
+
+    // One entry per distinct content, sorted by hash (first path in sorted order names it)
+    std::vector<const ScannedRom *> unique;
+    for (size_t romId = 0; romId < roms.size(); ++romId) {
+        if (roms[romId].valid) {
+            unique.push_back(&roms[romId]);
+        }
+    }
+
+    std::stable_sort(unique.begin(), unique.end(), [](const ScannedRom *left, const ScannedRom *right) {
+        return left->hash < right->hash;
+    });
+    unique.erase(std::unique(unique.begin(), unique.end(), [](const ScannedRom *left, const ScannedRom *right) {
+        return left->hash == right->hash;
+    }), unique.end());
+
+    std::vector<CorpusEntry> entries(unique.size());
+    std::string titles;
+
+    CorpusHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CORPUS_MAGIC, sizeof(CORPUS_MAGIC));
+    header.version          = CORPUS_VERSION;
+    header.entryCount       = static_cast<uint32_t>(unique.size());
+    header.entriesOffset    = sizeof(CorpusHeader);
+    header.titleIndexOffset = header.entriesOffset + entries.size()*sizeof(CorpusEntry);
+
+    for (size_t entryId = 0; entryId < unique.size(); ++entryId) {
+        const ScannedRom &rom = *unique[entryId];
+        CorpusEntry &entry = entries[entryId];
+
+        std::memset(&entry, 0, sizeof(entry));
+        entry.hash        = rom.hash;
+        entry.size        = static_cast<uint32_t>(rom.bytes.size());
+        entry.titleOffset = static_cast<uint32_t>(titles.size());
+        entry.titleLength = static_cast<uint16_t>(std::min<size_t>(rom.title.size(), UINT16_MAX));
+        entry.platform    = static_cast<uint8_t>(detect_rom_platform(rom.bytes.data(), rom.bytes.size()));
+        entry.quirks      = detect_rom_quirks(rom.bytes.data(), rom.bytes.size());
+
+        titles.append(rom.title, 0, entry.titleLength);
+    }
+
+    std::vector<uint32_t> titleIndex(unique.size());
+    for (uint32_t entryId = 0; entryId < titleIndex.size(); ++entryId) {
+        titleIndex[entryId] = entryId;
+    }
+    std::sort(titleIndex.begin(), titleIndex.end(), [&entries, &titles](uint32_t left, uint32_t right) {
+        return compare_titles(titles.data() + entries[left].titleOffset,  entries[left].titleLength,
+                              titles.data() + entries[right].titleOffset, entries[right].titleLength) < 0;
+    });
+
+    header.titlesOffset = align8(header.titleIndexOffset + titleIndex.size()*sizeof(uint32_t));
+    header.blobsOffset  = align8(header.titlesOffset + titles.size());
+
+    uint64_t blobOffset = header.blobsOffset;
+    for (size_t entryId = 0; entryId < entries.size(); ++entryId) {
+        entries[entryId].blobOffset = blobOffset;
+        blobOffset += entries[entryId].size;
+    }
+    header.fileSize = blobOffset;
+
+    // Written next to the destination, then renamed, so readers never map a half-written corpus
+    std::string temporaryFileName = outputFileName + ".tmp";
+    std::FILE *output = std::fopen(temporaryFileName.c_str(), "wb");
+    if (output == NULL) {
+        throw std::runtime_error("Could not create corpus file : `" + outputFileName + "`");
+    }
+
+    const char padding[8] = {0};
+    std::fwrite(&header, sizeof(header), 1, output);
+    std::fwrite(entries.data(), sizeof(CorpusEntry), entries.size(), output);
+    std::fwrite(titleIndex.data(), sizeof(uint32_t), titleIndex.size(), output);
+    std::fwrite(padding, 1, header.titlesOffset - (header.titleIndexOffset + titleIndex.size()*sizeof(uint32_t)), output);
+    std::fwrite(titles.data(), 1, titles.size(), output);
+    std::fwrite(padding, 1, header.blobsOffset - (header.titlesOffset + titles.size()), output);
+    for (size_t entryId = 0; entryId < unique.size(); ++entryId) {
+        std::fwrite(unique[entryId]->bytes.data(), 1, unique[entryId]->bytes.size(), output);
+    }
+
+    bool failed = std::ferror(output) != 0;
+    failed = std::fclose(output) != 0 || failed;
+
+    if (failed || std::rename(temporaryFileName.c_str(), outputFileName.c_str()) != 0) {
+        std::remove(temporaryFileName.c_str());
+        throw std::runtime_error("Could not write corpus file : `" + outputFileName + "`");
+    }
+
+    return entries.size();
+}
+
+RomPlatform detect_rom_platform(const uint8_t *bytes, size_t size) {
+    if (size > MAX_CHIP8_SIZE) {
+        return RomPlatform::XOCHIP;
+    }
+
+    std::vector<uint16_t> instructions = collect_reachable_instructions(bytes, size);
+    bool superChip = false;
+
+    for (size_t instructionId = 0; instructionId < instructions.size(); ++instructionId) {
+        uint16_t instruction = instructions[instructionId];
+        uint8_t  low         = instruction & 0xFF;
+
+        switch (instruction >> 12) {
+            case 0x0:
+                if ((instruction & 0xFFF0) == 0x00D0) {
+                    return RomPlatform::XOCHIP; // Scroll up
+                }
+                if ((instruction & 0xFFF0) == 0x00C0 || (instruction >= 0x00FB && instruction <= 0x00FF)) {
+                    superChip = true;
+                }
+                break;
+
+            case 0x5:
+                if ((instruction & 0xF) == 0x2 || (instruction & 0xF) == 0x3) {
+                    return RomPlatform::XOCHIP; // Register range save/load
+                }
+                break;
+
+            case 0xF:
+                if (instruction == 0xF000 || instruction == 0xF002 || low == 0x01 || low == 0x3A) {
+                    return RomPlatform::XOCHIP; // Long I, audio, planes, pitch
+                }
+                if (low == 0x30 || low == 0x75 || low == 0x85) {
+                    superChip = true; // Big font, RPL flags
+                }
+                break;
+        }
+    }
+
+    return superChip ? RomPlatform::SUPERCHIP : RomPlatform::CHIP8;
+}
+
+uint8_t detect_rom_quirks(const uint8_t *bytes, size_t size) {
+    std::vector<uint16_t> instructions = collect_reachable_instructions(bytes, size);
+    uint8_t quirks = 0;
+
+    for (size_t instructionId = 0; instructionId < instructions.size(); ++instructionId) {
+        uint16_t instruction = instructions[instructionId];
+
+        switch (instruction >> 12) {
+            case 0x8:
+                if ((instruction & 0xF) == 0x6 || (instruction & 0xF) == 0xE) {
+                    quirks |= QUIRK_SHIFT;
+                } else if ((instruction & 0xF) >= 0x1 && (instruction & 0xF) <= 0x3) {
+                    quirks |= QUIRK_LOGIC;
+                }
+                break;
+
+            case 0xB:
+                quirks |= QUIRK_JUMP;
+                break;
+
+            case 0xF:
+                if ((instruction & 0xFF) == 0x55 || (instruction & 0xFF) == 0x65) {
+                    quirks |= QUIRK_MEMORY;
+                }
+                break;
+        }
+    }
+
+    return quirks;
+}
+
+const char *get_platform_name(RomPlatform platform) {
+    switch (platform) {
+        case RomPlatform::SUPERCHIP:
+            return "superchip";
+
+        case RomPlatform::XOCHIP:
+            return "xochip";
+
+        default:
+        case RomPlatform::CHIP8:
+            return "chip8";
+    }
+}
@@ -0,0 +1,370 @@
+#include "RomRecompiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+    const uint16_t PROGRAM_START = 0x200;
+
+    /// Whether the interpreter implements `instruction` (anything else makes it throw)
+    bool is_supported(uint16_t instruction) {
+        uint8_t n  = instruction & 0xF;
+        uint8_t nn = instruction & 0xFF;
+
+        switch (instruction >> 12) {
+            case 0x8: return n <= 0x7 || n == 0xE;
+            case 0xE: return nn == 0x9E || nn == 0xA1;
+            case 0xF: return nn == 0x07 || nn == 0x0A || nn == 0x15 || nn == 0x18 || nn == 0x1E ||
+                             nn == 0x29 || nn == 0x33 || nn == 0x55 || nn == 0x65;
+            default:  return true;
+        }
+    }
+
+    /// Whether `instruction` may leave `pc` anywhere but on the next instruction, or writes memory (which may be code)
+    bool ends_block(uint16_t instruction) {
+        uint8_t nn = instruction & 0xFF;
+
+        switch (instruction >> 12) {
+            case 0x0: return instruction != 0x00E0; // Machine routines leave `pc` on themselves, like the interpreter
+            case 0x1: case 0x2: case 0x3: case 0x4: case 0x5: case 0x9: case 0xB: case 0xE:
+                return true;
+            case 0xF: return nn == 0x0A || nn == 0x33 || nn == 0x55;
+            default:  return false;
+        }
+    }
+
+    /// Instructions run through `RecompiledRuntime::interpret()` (drawing, keys, random numbers, memory writes)
+    bool is_interpreted(uint16_t instruction) {
+        uint8_t nn = instruction & 0xFF;
+
+        switch (instruction >> 12) {
+            case 0x0: return instruction != 0x00EE; // 00E0 and the (ignored) machine routines
+            case 0xC: case 0xD: case 0xE:
+                return true;
+            case 0xF: return nn == 0x0A || nn == 0x33 || nn == 0x55;
+            default:  return false;
+        }
+    }
+
+    std::string hex(unsigned int value, int digits) {
+        char text[16];
+        std::snprintf(text, sizeof(text), "0x%0*X", digits, value);
+        return text;
+    }
+}
+
+RomRecompiler::RomRecompiler(const uint8_t *program, size_t programSize) : program(program, program + programSize),
+                                                                           computedJumps(0) {
+    if (programSize > 4096 - PROGRAM_START) {
+        throw std::runtime_error("Program is too big to fit in the memory (" + std::to_string(programSize) + " bytes)");
+    }
+
+    this->reached.fill(0);
+    this->leaders.fill(0);
+
+    this->explore();
+    this->build_blocks();
+}
+
+/// Marks every instruction reachable from the entry point, and the addresses blocks start at
+void RomRecompiler::explore() {
+    std::vector<uint16_t> pending(1, PROGRAM_START);
+    this->leaders[PROGRAM_START] = 1;
+
+    while (!pending.empty()) {
+        uint16_t address = pending.back();
+        pending.pop_back();
+
+        if (!this->contains(address) || this->reached[address]) {
+            continue;
+        }
+
+        uint16_t instruction = this->instruction_at(address);
+        if (!is_supported(instruction)) {
+            continue; // Left to the interpreter, which reports it
+        }
+        this->reached[address] = 1;
+
+        uint16_t target = instruction & 0xFFF;
+        std::vector<uint16_t> successors;
+
+        switch (instruction >> 12) {
+            case 0x0:
+                if (instruction == 0x00E0) {
+                    successors.push_back(address + 2); // Neither 00EE nor a machine routine (which never leaves) falls through
+                }
+                break;
+
+            case 0x1:
+                successors.push_back(target);
+                break;
+
+            case 0x2:
+                successors.push_back(target);
+                successors.push_back(address + 2); // Where 00EE comes back to
+                break;
+
+            case 0x3: case 0x4: case 0x5: case 0x9: case 0xE:
+                successors.push_back(address + 2);
+                successors.push_back(address + 4);
+                break;
+
+            case 0xB:
+                ++this->computedJumps; // Target only known at run time
+                break;
+
+            case 0xF:
+                if ((instruction & 0xFF) == 0x0A) {
+                    successors.push_back(address); // Waits for a key by running again
+                }
+                successors.push_back(address + 2);
+                break;
+
+            default:
+                successors.push_back(address + 2);
+                break;
+        }
+
+        for (size_t successorId = 0; successorId < successors.size(); ++successorId) {
+            if (ends_block(instruction) && successors[successorId] < this->leaders.size()) {
+                this->leaders[successors[successorId]] = 1;
+            }
+            pending.push_back(successors[successorId]);
+        }
+    }
+}
+
+/// Cuts the reachable code into blocks : each one runs from a leader to its first block-ending instruction
+void RomRecompiler::build_blocks() {
+    for (uint16_t address = PROGRAM_START; this->contains(address); ++address) {
+        if (!this->leaders[address] || !this->reached[address]) {
+            continue;
+        }
+
+        Block block;
+        block.address = address;
+
+        uint16_t current = address;
+        while (true) {
+            uint16_t instruction = this->instruction_at(current);
+            block.instructions.push_back(instruction);
+
+            current += 2;
+            if (ends_block(instruction) || !this->contains(current) || !this->reached[current] || this->leaders[current]) {
+                break;
+            }
+        }
+
+        if (block.instructions.size() == 1 && is_interpreted(block.instructions[0])) {
+            continue; // Nothing native in it : the interpreter runs it just as fast (e.g. FX0A waiting for a key)
+        }
+        this->blocks.push_back(block);
+    }
+}
+
+/// Whether a whole instruction of the program starts at `address`
+bool RomRecompiler::contains(uint32_t address) const {
+    return address >= PROGRAM_START && address + 2 <= PROGRAM_START + this->program.size();
+}
+
+uint16_t RomRecompiler::instruction_at(uint16_t address) const {
+    return static_cast<uint16_t>(this->program[address - PROGRAM_START] << 8 | this->program[address - PROGRAM_START + 1]);
+}
+
+void RomRecompiler::emit(std::ostream &output, const std::string &title) const {
+    if (this->blocks.empty()) {
+        throw std::runtime_error("Nothing to recompile in `" + title + "` : its first instruction isn't supported");
+    }
+
+    size_t maxBlockSize = 0;
+    for (size_t blockId = 0; blockId < this->blocks.size(); ++blockId) {
+        maxBlockSize = std::max(maxBlockSize, 2 * this->blocks[blockId].instructions.size());
+    }
+
+    std::string escapedTitle;
+    for (size_t charId = 0; charId < title.size(); ++charId) {
+        if (title[charId] == '"' || title[charId] == '\\') {
+            escapedTitle += '\\';
+        }
+        escapedTitle += title[charId];
+    }
+
+    output << "// Generated by chip8pp-aot from `" << title << "` : do not edit.\n"
+           << "// " << this->blocks.size() << " blocks, " << this->get_instruction_count() << " instructions, "
+           << this->computedJumps << " computed jumps left to the interpreter.\n\n"
+           << "#include \"RecompiledRuntime.hpp\"\n\n"
+           << "namespace {\n"
+           << "    typedef RecompiledRuntime R;\n\n";
+
+    output << "    const uint8_t IMAGE[] = {";
+    for (size_t byteId = 0; byteId < this->program.size(); ++byteId) {
+        output << (byteId % 16 == 0 ? "\n        " : " ") << hex(this->program[byteId], 2) << ",";
+    }
+    output << "\n    };\n\n";
+
+    output << "    const RecompiledBlock BLOCKS[] = {\n";
+    for (size_t blockId = 0; blockId < this->blocks.size(); ++blockId) {
+        const Block &block = this->blocks[blockId];
+        output << "        {" << hex(block.address, 3) << ", " << 2 * block.instructions.size() << "},\n";
+    }
+    output << "    };\n\n";
+
+    for (size_t blockId = 0; blockId < this->blocks.size(); ++blockId) {
+        this->emit_block(output, this->blocks[blockId]);
+    }
+
+    output << "    uint64_t dispatch(Chip8 &core, uint16_t address, uint64_t budget) {\n"
+           << "        switch (address) {\n";
+    for (size_t blockId = 0; blockId < this->blocks.size(); ++blockId) {
+        const Block &block = this->blocks[blockId];
+        output << "            case " << hex(block.address, 3) << ": return budget >= " << block.instructions.size()
+               << " ? block_" << hex(block.address, 3) << "(core) : 0;\n";
+    }
+    output << "            default: return 0;\n"
+           << "        }\n"
+           << "    }\n\n";
+
+    output << "    const RecompiledRom ROM = {\"" << escapedTitle << "\", IMAGE, sizeof(IMAGE), BLOCKS, "
+           << "sizeof(BLOCKS) / sizeof(BLOCKS[0]), " << maxBlockSize << ", dispatch};\n\n"
+           << "    RecompiledRomRegistrar registrar(&ROM);\n"
+           << "}\n";
+}
+
+/// One block as a function : statements for every instruction, then `pc` unless the last one set it
+void RomRecompiler::emit_block(std::ostream &output, const Block &block) const {
+    std::vector<std::string> statements;
+    bool usesRegisters = false;
+    bool usesIndex     = false;
+    bool setsPc        = false;
+
+    for (size_t instructionId = 0; instructionId < block.instructions.size(); ++instructionId) {
+        uint16_t    address     = static_cast<uint16_t>(block.address + 2 * instructionId);
+        uint16_t    instruction = block.instructions[instructionId];
+        uint8_t     x           = (instruction >> 8) & 0xF;
+        uint8_t     y           = (instruction >> 4) & 0xF;
+        std::string vx          = "v[" + std::to_string(x) + "]";
+        std::string vy          = "v[" + std::to_string(y) + "]";
+        std::string nn          = hex(instruction & 0xFF, 2);
+        std::string nnn         = hex(instruction & 0xFFF, 3);
+        std::string next        = hex(address + 2, 3);
+        std::string skip        = hex(address + 4, 3);
+        std::string code;
+
+        bool lastInstruction = instructionId + 1 == block.instructions.size();
+        setsPc = lastInstruction && ends_block(instruction);
+
+        if (is_interpreted(instruction)) {
+            code = "R::interpret(core, " + hex(address, 3) + ", " + hex(instruction, 4) + ");";
+        } else {
+            switch (instruction >> 12) {
+                case 0x0:
+                    code = "R::ret(core);"; // 00EE, the others are interpreted
+                    break;
+
+                case 0x1: code = "pc = " + nnn + ";";                                    break;
+                case 0x2: code = "R::call(core, " + hex(address, 3) + ", " + nnn + ");"; break;
+                case 0x3: code = "pc = " + vx + " == " + nn + " ? " + skip + " : " + next + ";"; break;
+                case 0x4: code = "pc = " + vx + " != " + nn + " ? " + skip + " : " + next + ";"; break;
+                case 0x5: code = "pc = " + vx + " == " + vy + " ? " + skip + " : " + next + ";"; break;
+                case 0x9: code = "pc = " + vx + " != " + vy + " ? " + skip + " : " + next + ";"; break;
+                case 0x6: code = vx + " = " + nn + ";";                                  break;
+                case 0x7: code = vx + " = static_cast<uint8_t>(" + vx + " + " + nn + ");"; break;
+
+                case 0x8:
+                    switch (instruction & 0xF) { // Same flag order as the interpreter, VF may also be VX or VY
+                        case 0x0: code = vx + " = " + vy + ";";  break;
+                        case 0x1: code = vx + " |= " + vy + ";"; break;
+                        case 0x2: code = vx + " &= " + vy + ";"; break;
+                        case 0x3: code = vx + " ^= " + vy + ";"; break;
+                        case 0x4: code = "{ unsigned int sum = " + vx + " + " + vy + "; v[15] = sum > 255 ? 1 : 0; " + vx +
+                                         " = static_cast<uint8_t>(sum); }";
+                                  break;
+                        case 0x5: code = "v[15] = " + vx + " > " + vy + " ? 1 : 0; " + vx + " = static_cast<uint8_t>(" + vx +
+                                         " - " + vy + ");";
+                                  break;
+                        case 0x6: code = "v[15] = " + std::to_string(y & 1) + "; " + vx + " = " + vy + " >> 1;"; break;
+                        case 0x7: code = "v[15] = " + vy + " > " + vx + " ? 1 : 0; " + vx + " = static_cast<uint8_t>(" + vy +
+                                         " - " + vx + ");";
+                                  break;
+                        default:  code = "v[15] = " + std::to_string((y & 0x80) >> 7) + "; " + vx + " = static_cast<uint8_t>(" +
+                                         vy + " << 1);";
+                                  break;
+                    }
+                    break;
+
+                case 0xA: code = "i = " + nnn + ";"; usesIndex = true; break;
+                case 0xB: code = "pc = static_cast<uint16_t>(" + nnn + " + v[0]);"; break;
+
+                default: // 0xF
+                    switch (instruction & 0xFF) {
+                        case 0x07: code = vx + " = R::delay_timer(core);";                          break;
+                        case 0x15: code = "R::delay_timer(core) = " + vx + ";";                     break;
+                        case 0x18: code = "R::sound_timer(core) = " + vx + ";";                     break;
+                        case 0x1E: code = "i = static_cast<uint16_t>(i + " + vx + ");";        usesIndex = true; break;
+                        case 0x29: code = "i = static_cast<uint16_t>(0x50 + 5 * " + vx + ");"; usesIndex = true; break;
+                        default: // 0x65
+                            for (uint8_t registerId = 0; registerId <= x; ++registerId) {
+                                code += (registerId > 0 ? " " : "") + std::string("v[") + std::to_string(registerId) +
+                                        "] = R::read(core, i + " + std::to_string(registerId) + ");";
+                            }
+                            usesIndex = true;
+                            break;
+                    }
+                    break;
+            }
+        }
+
+        usesRegisters = usesRegisters || code.find("v[") != std::string::npos;
+
+        char comment[16];
+        std::snprintf(comment, sizeof(comment), "%03X: %04X", address, instruction);
+        statements.push_back(code + " // " + comment);
+    }
+
+    uint16_t end = static_cast<uint16_t>(block.address + 2 * block.instructions.size());
+    if (!setsPc) {
+        statements.push_back("pc = " + hex(end, 3) + ";");
+    }
+
+    bool usesPc = false;
+    for (size_t statementId = 0; statementId < statements.size(); ++statementId) {
+        usesPc = usesPc || statements[statementId].compare(0, 5, "pc = ") == 0;
+    }
+
+    output << "    uint64_t block_" << hex(block.address, 3) << "(Chip8 &core) {\n";
+    if (usesRegisters) {
+        output << "        uint8_t  *v   = R::registers(core);\n";
+    }
+    if (usesIndex) {
+        output << "        uint16_t &i   = R::index(core);\n";
+    }
+    if (usesPc) {
+        output << "        uint16_t &pc  = R::pc(core);\n";
+    }
+    if (usesRegisters || usesIndex || usesPc) {
+        output << "\n";
+    }
+
+    for (size_t statementId = 0; statementId < statements.size(); ++statementId) {
+        output << "        " << statements[statementId] << "\n";
+    }
+    output << "        return " << block.instructions.size() << ";\n"
+           << "    }\n\n";
+}
+
+size_t RomRecompiler::get_block_count() const {
+    return this->blocks.size();
+}
+
+size_t RomRecompiler::get_instruction_count() const {
+    size_t count = 0;
+    for (size_t blockId = 0; blockId < this->blocks.size(); ++blockId) {
+        count += this->blocks[blockId].instructions.size();
+    }
+    return count;
+}
+
+size_t RomRecompiler::get_computed_jump_count() const {
+    return this->computedJumps;
+}
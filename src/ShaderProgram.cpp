@@ -0,0 +1,228 @@
+#include "ShaderProgram.hpp"
+#include "Hash.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+    const char CACHE_MAGIC[8] = {'C', '8', 'P', 'R', 'O', 'G', '0', '1'};
+
+    struct CacheHeader {
+        char     magic[8];   ///< CACHE_MAGIC
+        uint64_t key;        ///< Hash of the sources and driver strings
+        uint32_t format;     ///< Binary format returned by the driver
+        uint32_t binarySize; ///< Bytes following the header
+    };
+
+    std::string gl_string(GLenum name) {
+        const GLubyte *value = glGetString(name);
+        return value == NULL ? std::string() : std::string(reinterpret_cast<const char *>(value));
+    }
+
+    /// Cache directory, created if needed (empty when caching is impossible)
+    std::string cache_directory() {
+        const char *configured = std::getenv("CHIP8PP_CACHE_DIR");
+        if (configured != NULL && configured[0] != '\0') {
+            ::mkdir(configured, 0755);
+            return configured;
+        }
+
+        std::string base;
+        const char *xdgCache = std::getenv("XDG_CACHE_HOME");
+        const char *home     = std::getenv("HOME");
+
+        if (xdgCache != NULL && xdgCache[0] != '\0') {
+            base = xdgCache;
+        } else if (home != NULL && home[0] != '\0') {
+            base = std::string(home) + "/.cache";
+        } else {
+            return std::string();
+        }
+
+        ::mkdir(base.c_str(), 0755);
+        ::mkdir((base + "/chip8pp").c_str(), 0755);
+
+        return base + "/chip8pp";
+    }
+
+    std::string info_log(GLuint object, bool isProgram) {
+        GLint logSize = 0;
+        if (isProgram) {
+            glGetProgramiv(object, GL_INFO_LOG_LENGTH, &logSize);
+        } else {
+            glGetShaderiv(object, GL_INFO_LOG_LENGTH, &logSize);
+        }
+
+        if (logSize <= 0) {
+            return std::string();
+        }
+
+        std::vector<GLchar> log(logSize);
+        if (isProgram) {
+            glGetProgramInfoLog(object, logSize, NULL, log.data());
+        } else {
+            glGetShaderInfoLog(object, logSize, NULL, log.data());
+        }
+
+        return std::string(log.data());
+    }
+
+    GLuint compile_shader(const std::string &name, GLenum type, const std::string &source) {
+        GLuint shaderAddress = glCreateShader(type);
+
+        const char *sourceRaw  = source.c_str();
+        const int   sourceSize = static_cast<int>(source.length());
+
+        glShaderSource(shaderAddress, 1, &sourceRaw, &sourceSize);
+        glCompileShader(shaderAddress);
+
+        GLint success = 0;
+        glGetShaderiv(shaderAddress, GL_COMPILE_STATUS, &success);
+
+        if (success == GL_FALSE) {
+            std::string log = info_log(shaderAddress, false);
+            glDeleteShader(shaderAddress);
+
+            throw std::runtime_error("OpenGL " + name + (type == GL_VERTEX_SHADER ? " vertex" : " fragment") + " shader exception : " + log);
+        }
+
+        return shaderAddress;
+    }
+
+    bool load_cached_binary(GLuint programAddress, const std::string &fileName, uint64_t key) {
+        int fileDescriptor = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fileDescriptor < 0) {
+            return false;
+        }
+
+        CacheHeader header;
+        std::vector<uint8_t> binary;
+        bool valid = ::read(fileDescriptor, &header, sizeof(header)) == static_cast<ssize_t>(sizeof(header))
+                  && std::equal(header.magic, header.magic + 8, CACHE_MAGIC)
+                  && header.key == key;
+
+        if (valid) {
+            binary.resize(header.binarySize);
+            valid = ::read(fileDescriptor, binary.data(), binary.size()) == static_cast<ssize_t>(binary.size());
+        }
+        ::close(fileDescriptor);
+
+        if (!valid) {
+            return false;
+        }
+
+        glProgramBinary(programAddress, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+        GLint success = 0;
+        glGetProgramiv(programAddress, GL_LINK_STATUS, &success);
+
+        return success == GL_TRUE; // The driver may reject binaries, e.g. after an update it doesn't advertise
+    }
+
+    void store_cached_binary(GLuint programAddress, const std::string &fileName, uint64_t key) {
+        GLint binarySize = 0;
+        glGetProgramiv(programAddress, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+        if (binarySize <= 0) {
+            return;
+        }
+
+        CacheHeader header;
+        std::copy(CACHE_MAGIC, CACHE_MAGIC + 8, header.magic);
+        header.key = key;
+
+        std::vector<uint8_t> binary(binarySize);
+        GLenum format = 0;
+        glGetProgramBinary(programAddress, binarySize, NULL, &format, binary.data());
+
+        header.format     = format;
+        header.binarySize = static_cast<uint32_t>(binary.size());
+
+        // Written aside then renamed, so concurrent launches never read a partial file
+        std::string temporaryName = fileName + ".tmp" + std::to_string(::getpid());
+        std::FILE *file = std::fopen(temporaryName.c_str(), "wb");
+        if (file == NULL) {
+            return;
+        }
+
+        bool written = std::fwrite(&header, sizeof(header), 1, file) == 1
+                    && std::fwrite(binary.data(), binary.size(), 1, file) == 1;
+
+        if (std::fclose(file) == 0 && written) {
+            std::rename(temporaryName.c_str(), fileName.c_str());
+        } else {
+            std::remove(temporaryName.c_str());
+        }
+    }
+}
+
+GLuint create_shader_program(const std::string &name, const std::string &vertexSource, const std::string &fragmentSource) {
+    GLint binaryFormatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+
+    std::string directory = binaryFormatCount > 0 ? cache_directory() : std::string();
+    std::string cacheFileName;
+    uint64_t    key = 0;
+
+    GLuint programAddress = glCreateProgram();
+
+    if (!directory.empty()) {
+        std::string identity = gl_string(GL_VENDOR) + '\n' + gl_string(GL_RENDERER) + '\n' + gl_string(GL_VERSION) + '\n'
+                             + vertexSource + '\n' + fragmentSource;
+        key = xxhash64(identity.data(), identity.size());
+
+        char keyText[17];
+        std::snprintf(keyText, sizeof(keyText), "%016llx", (unsigned long long)key);
+        cacheFileName = directory + "/" + name + "-" + keyText + ".bin";
+
+        if (load_cached_binary(programAddress, cacheFileName, key)) {
+            return programAddress;
+        }
+    }
+
+    GLuint vShaderAddress = 0;
+    GLuint fShaderAddress = 0;
+    try {
+        vShaderAddress = compile_shader(name, GL_VERTEX_SHADER, vertexSource);
+        fShaderAddress = compile_shader(name, GL_FRAGMENT_SHADER, fragmentSource);
+    } catch (...) {
+        glDeleteShader(vShaderAddress); // Ignored when 0
+        glDeleteProgram(programAddress);
+        throw;
+    }
+
+    glAttachShader(programAddress, vShaderAddress);
+    glAttachShader(programAddress, fShaderAddress);
+
+    if (!cacheFileName.empty()) {
+        glProgramParameteri(programAddress, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    glLinkProgram(programAddress);
+
+    glDetachShader(programAddress, vShaderAddress);
+    glDetachShader(programAddress, fShaderAddress);
+    glDeleteShader(vShaderAddress);
+    glDeleteShader(fShaderAddress);
+
+    GLint success = 0;
+    glGetProgramiv(programAddress, GL_LINK_STATUS, &success);
+
+    if (success == GL_FALSE) {
+        std::string log = info_log(programAddress, true);
+        glDeleteProgram(programAddress);
+
+        throw std::runtime_error("OpenGL " + name + " shader program failed to link : " + log);
+    }
+
+    if (!cacheFileName.empty()) {
+        store_cached_binary(programAddress, cacheFileName, key);
+    }
+
+    return programAddress;
+}
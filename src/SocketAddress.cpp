@@ -0,0 +1,53 @@
+#include "SocketAddress.hpp"
+
+#include <cstring>
+#include <netdb.h>
+#include <stdexcept>
+#include <sys/un.h>
+
+socklen_t resolve_socket_address(const std::string &address, const std::string &ipScheme, int socketType, int family,
+                                 struct sockaddr_storage &resolved) {
+    std::memset(&resolved, 0, sizeof(resolved));
+
+    if (address.compare(0, 5, "unix:") == 0 && (family == AF_UNSPEC || family == AF_UNIX)) {
+        struct sockaddr_un &unixAddress = reinterpret_cast<struct sockaddr_un &>(resolved);
+        std::string         path        = address.substr(5);
+
+        if (path.empty() || path.size() >= sizeof(unixAddress.sun_path)) {
+            throw std::runtime_error("Socket error : invalid Unix socket path `" + path + "`");
+        }
+        unixAddress.sun_family = AF_UNIX;
+        std::memcpy(unixAddress.sun_path, path.c_str(), path.size() + 1);
+        return static_cast<socklen_t>(sizeof(unixAddress));
+    }
+
+    std::string prefix        = ipScheme + ":";
+    size_t      portSeparator = address.rfind(':');
+    if (address.compare(0, prefix.size(), prefix) != 0 || portSeparator < prefix.size() || family == AF_UNIX) {
+        throw std::runtime_error("Socket error : `" + address + "` isn't " + ipScheme + ":HOST:PORT or unix:PATH");
+    }
+
+    std::string host = address.substr(prefix.size(), portSeparator - prefix.size());
+    std::string port = address.substr(portSeparator + 1);
+    if (host.size() >= 2 && host[0] == '[' && host[host.size() - 1] == ']') { // IPv6, e.g. udp:[::1]:7000
+        host = host.substr(1, host.size() - 2);
+    }
+
+    struct addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = family;
+    hints.ai_socktype = socketType;
+    hints.ai_flags    = AI_NUMERICSERV | (host.empty() ? AI_PASSIVE : 0);
+
+    struct addrinfo *results = NULL;
+    int status = ::getaddrinfo(host.empty() ? NULL : host.c_str(), port.c_str(), &hints, &results);
+    if (status != 0) {
+        throw std::runtime_error("Socket error : can't resolve `" + address + "` (" + ::gai_strerror(status) + ")");
+    }
+
+    socklen_t size = static_cast<socklen_t>(results->ai_addrlen);
+    std::memcpy(&resolved, results->ai_addr, size);
+    ::freeaddrinfo(results);
+
+    return size;
+}
@@ -0,0 +1,113 @@
+#include "TerminalRenderer.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <unistd.h>
+
+namespace {
+    // Indexed by (top pixel << 1) | bottom pixel
+    const char *const HALF_BLOCKS[4] = {" ", "\xE2\x96\x84", "\xE2\x96\x80", "\xE2\x96\x88"}; // ' ', '▄', '▀', '█'
+
+    inline unsigned int cell_of(const DisplayView &view, unsigned int cellRow, unsigned int column) {
+        return (view.pixel(column, 2*cellRow) ? 2 : 0) | (view.pixel(column, 2*cellRow + 1) ? 1 : 0);
+    }
+}
+
+TerminalRenderer::TerminalRenderer(int fileDescriptor, unsigned int originRow, unsigned int originColumn)
+    : fileDescriptor(fileDescriptor), originRow(originRow),
+      originColumn(originColumn),     fullRedraw(true) {
+    this->previousRows.fill(0);
+    this->frameBuffer.reserve(16 * 64 * 8); // Worst case full repaint, without reallocation afterwards
+}
+
+TerminalRenderer::~TerminalRenderer() {
+    this->frameBuffer.clear();
+    this->move_cursor(this->originRow + 16, 1);
+    this->frameBuffer.append("\x1b[0m\x1b[?25h"); // Reset attributes, show the cursor back
+    this->flush();
+}
+
+size_t TerminalRenderer::render(const DisplayView &view) {
+    this->frameBuffer.clear();
+
+    if (this->fullRedraw) {
+        this->frameBuffer.append("\x1b[?25l\x1b[2J"); // Hide cursor, clear screen
+    }
+
+    bool cursorKnown = false;
+    unsigned int cursorRow    = 0;
+    unsigned int cursorColumn = 0;
+
+    for (unsigned int cellRow = 0; cellRow < 16; ++cellRow) {
+        uint64_t changed = (view.row(2*cellRow) ^ this->previousRows[2*cellRow]) | (view.row(2*cellRow + 1) ^ this->previousRows[2*cellRow + 1]);
+        if (this->fullRedraw) {
+            changed = ~0ULL;
+        }
+
+        while (changed != 0) {
+            unsigned int column = static_cast<unsigned int>(__builtin_clzll(changed)); // MSB is the leftmost pixel
+            changed &= ~(1ULL << (63 - column));
+
+            if (!cursorKnown || cursorRow != cellRow || cursorColumn != column) {
+                this->move_cursor(this->originRow + cellRow, this->originColumn + column);
+            }
+
+            this->frameBuffer.append(HALF_BLOCKS[cell_of(view, cellRow, column)]);
+
+            cursorKnown  = true;
+            cursorRow    = cellRow;
+            cursorColumn = column + 1; // Terminal advanced by one cell
+        }
+    }
+
+    for (unsigned int y = 0; y < DisplayView::HEIGHT; ++y) {
+        this->previousRows[y] = view.row(y);
+    }
+    this->fullRedraw = false;
+
+    size_t written = this->frameBuffer.size();
+    this->flush();
+
+    return written;
+}
+
+void TerminalRenderer::invalidate() {
+    this->fullRedraw = true;
+}
+
+std::string TerminalRenderer::to_text(const DisplayView &view) {
+    std::string text;
+    text.reserve(16 * (64*3 + 1));
+
+    for (unsigned int cellRow = 0; cellRow < 16; ++cellRow) {
+        for (unsigned int column = 0; column < 64; ++column) {
+            text.append(HALF_BLOCKS[cell_of(view, cellRow, column)]);
+        }
+        text.append("\n");
+    }
+
+    return text;
+}
+
+void TerminalRenderer::move_cursor(unsigned int row, unsigned int column) {
+    char sequence[24];
+    int length = std::snprintf(sequence, sizeof(sequence), "\x1b[%u;%uH", row, column);
+    this->frameBuffer.append(sequence, static_cast<size_t>(length));
+}
+
+void TerminalRenderer::flush() {
+    const char *data = this->frameBuffer.data();
+    size_t remaining = this->frameBuffer.size();
+
+    while (remaining > 0) { // One write per frame, unless the pipe accepts it partially
+        ssize_t written = ::write(this->fileDescriptor, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        data      += written;
+        remaining -= static_cast<size_t>(written);
+    }
+}
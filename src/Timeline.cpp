@@ -0,0 +1,241 @@
+#include "Timeline.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <time.h>
+#include <unistd.h>
+
+std::atomic<bool> Timeline::recording(false);
+
+/// Hands the ring of a thread back to `Timeline` when the thread exits
+struct Timeline::BufferLease {
+    TimelineBuffer *buffer; ///< NULL until the thread records something
+
+    BufferLease() : buffer(NULL) {}
+
+    ~BufferLease() {
+        if (this->buffer != NULL) {
+            Timeline::instance().release_buffer(this->buffer);
+        }
+    }
+};
+
+Timeline::Timeline() {}
+
+Timeline &Timeline::instance() {
+    static Timeline timeline;
+    return timeline;
+}
+
+/// Monotonic nanoseconds, the clock of every event
+uint64_t Timeline::now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000 + static_cast<uint64_t>(time.tv_nsec);
+}
+
+/// Records an event that ran from `startNs` to `endNs`
+void Timeline::complete(const char *name, const char *category, uint64_t startNs, uint64_t endNs, const char *argName, int64_t argValue) {
+    if (!Timeline::enabled()) {
+        return;
+    }
+
+    TimelineEvent event = {name, category, argName, argValue, startNs, endNs > startNs ? endNs - startNs : 0, 'X'};
+    Timeline::record(event);
+}
+
+/// Records an event without duration, happening now
+void Timeline::instant(const char *name, const char *category, const char *argName, int64_t argValue) {
+    if (!Timeline::enabled()) {
+        return;
+    }
+
+    TimelineEvent event = {name, category, argName, argValue, Timeline::now(), 0, 'i'};
+    Timeline::record(event);
+}
+
+/// Names the calling thread in the trace viewer
+void Timeline::name_thread(const std::string &name) {
+    TimelineBuffer &buffer   = Timeline::local();
+    Timeline       &timeline = Timeline::instance();
+
+    std::lock_guard<std::mutex> lock(timeline.mutex);
+    buffer.threadName  = name;
+    buffer.nameWritten = false;
+}
+
+/// Ring of the calling thread
+TimelineBuffer &Timeline::local() {
+    static thread_local BufferLease lease;
+
+    if (lease.buffer == NULL) {
+        lease.buffer = Timeline::instance().acquire_buffer();
+    }
+    return *lease.buffer;
+}
+
+/// Appends to the caller's ring, or drops the event when the writer is a whole ring behind
+void Timeline::record(const TimelineEvent &event) {
+    TimelineBuffer &buffer = Timeline::local();
+    uint64_t        head   = buffer.head.load(std::memory_order_relaxed);
+    uint64_t        used   = head - buffer.tail.load(std::memory_order_acquire);
+
+    if (used >= TimelineBuffer::CAPACITY) {
+        buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer.events[head % TimelineBuffer::CAPACITY] = event;
+    buffer.head.store(head + 1, std::memory_order_release); // Publishes the event to the writer
+
+    if (used + 1 == TimelineBuffer::CAPACITY / 2) {
+        Timeline::instance().drainRequested.notify_one(); // Once per half ring; a missed wakeup only waits for the period
+    }
+}
+
+TimelineBuffer *Timeline::acquire_buffer() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    if (!this->freeBuffers.empty()) {
+        TimelineBuffer *buffer = this->freeBuffers.back();
+        this->freeBuffers.pop_back();
+        return buffer;
+    }
+
+    this->buffers.push_back(std::unique_ptr<TimelineBuffer>(new TimelineBuffer())); // Value-initialized : empty ring
+    TimelineBuffer *buffer = this->buffers.back().get();
+
+    buffer->threadId   = static_cast<unsigned int>(this->buffers.size());
+    buffer->threadName = "thread " + std::to_string(buffer->threadId);
+    return buffer;
+}
+
+void Timeline::release_buffer(TimelineBuffer *buffer) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->freeBuffers.push_back(buffer); // Its pending events are still drained
+}
+
+TimelineWriter::TimelineWriter(const std::string &path) : output(path.c_str(), std::ios::out | std::ios::trunc),
+                                                          originNs(Timeline::now()),
+                                                          firstEvent(true),
+                                                          written(0),
+                                                          stopping(false) {
+    if (!this->output) {
+        throw std::runtime_error("Timeline error : can't write `" + path + "`");
+    }
+    if (Timeline::recording.exchange(true)) {
+        throw std::runtime_error("Timeline error : a timeline is already being recorded");
+    }
+
+    {
+        Timeline &timeline = Timeline::instance();
+        std::lock_guard<std::mutex> lock(timeline.mutex);
+
+        for (size_t bufferId = 0; bufferId < timeline.buffers.size(); ++bufferId) {
+            TimelineBuffer &buffer = *timeline.buffers[bufferId];
+
+            buffer.tail.store(buffer.head.load(std::memory_order_acquire), std::memory_order_release); // Left over by a previous writer
+            buffer.dropped.store(0, std::memory_order_relaxed);
+            buffer.nameWritten = false;
+        }
+    }
+
+    this->output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    this->thread = std::thread(&TimelineWriter::drain_periodically, this);
+}
+
+TimelineWriter::~TimelineWriter() {
+    Timeline::recording.store(false);
+
+    this->stopping.store(true);
+    this->thread.join();
+
+    this->drain();
+
+    uint64_t dropped = 0;
+    {
+        Timeline &timeline = Timeline::instance();
+        std::lock_guard<std::mutex> lock(timeline.mutex);
+
+        for (size_t bufferId = 0; bufferId < timeline.buffers.size(); ++bufferId) {
+            dropped += timeline.buffers[bufferId]->dropped.load(std::memory_order_relaxed);
+        }
+    }
+
+    this->output << "\n],\"otherData\":{\"droppedEvents\":" << dropped << "}}\n";
+    this->output.close();
+
+    std::cerr << "TIMELINE : " << this->written << " events written, " << dropped << " dropped\n";
+}
+
+void TimelineWriter::drain_periodically() {
+    Timeline &timeline = Timeline::instance();
+
+    while (!this->stopping.load()) {
+        {
+            std::unique_lock<std::mutex> lock(timeline.wakeMutex);
+            timeline.drainRequested.wait_for(lock, std::chrono::milliseconds(FLUSH_PERIOD_MS));
+        }
+        this->drain();
+    }
+}
+
+/// Writes the events recorded since the last drain, ring after ring; returns how many
+uint64_t TimelineWriter::drain() {
+    Timeline &timeline = Timeline::instance();
+    std::lock_guard<std::mutex> lock(timeline.mutex); // Only held against thread arrivals, exits and renames
+
+    uint64_t drained = 0;
+    for (size_t bufferId = 0; bufferId < timeline.buffers.size(); ++bufferId) {
+        TimelineBuffer &buffer = *timeline.buffers[bufferId];
+        uint64_t        tail   = buffer.tail.load(std::memory_order_relaxed);
+        uint64_t        head   = buffer.head.load(std::memory_order_acquire);
+
+        if (tail != head && !buffer.nameWritten) {
+            this->write_thread_name(buffer);
+            buffer.nameWritten = true;
+        }
+
+        for (uint64_t eventId = tail; eventId != head; ++eventId) {
+            this->write_event(buffer.events[eventId % TimelineBuffer::CAPACITY], buffer.threadId);
+        }
+        buffer.tail.store(head, std::memory_order_release); // Hands the slots back to the thread
+
+        drained += head - tail;
+    }
+
+    this->written += drained;
+    this->output.flush();
+
+    return drained;
+}
+
+void TimelineWriter::write_event(const TimelineEvent &event, unsigned int threadId) {
+    char line[320];
+    int  size = std::snprintf(line, sizeof(line), "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u",
+                              this->firstEvent ? "" : ",", event.name, event.category, event.phase,
+                              static_cast<double>(static_cast<int64_t>(event.startNs - this->originNs)) * 1e-3, static_cast<int>(::getpid()), threadId);
+
+    if (event.phase == 'X') {
+        size += std::snprintf(line + size, sizeof(line) - size, ",\"dur\":%.3f", static_cast<double>(event.durationNs) * 1e-3);
+    } else {
+        size += std::snprintf(line + size, sizeof(line) - size, ",\"s\":\"t\""); // Instant scoped to its thread
+    }
+    if (event.argName != NULL) {
+        size += std::snprintf(line + size, sizeof(line) - size, ",\"args\":{\"%s\":%lld}", event.argName, (long long)event.argValue);
+    }
+    std::snprintf(line + size, sizeof(line) - size, "}");
+
+    this->output << line;
+    this->firstEvent = false;
+}
+
+/// Metadata event naming a thread (names are written as they are, without JSON escaping)
+void TimelineWriter::write_thread_name(const TimelineBuffer &buffer) {
+    this->output << (this->firstEvent ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << ::getpid()
+                 << ",\"tid\":" << buffer.threadId << ",\"args\":{\"name\":\"" << buffer.threadName << "\"}}";
+    this->firstEvent = false;
+}
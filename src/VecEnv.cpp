@@ -0,0 +1,138 @@
+#include "VecEnv.hpp"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    /// Each byte value expanded to 8 pixel bytes, most significant bit first
+    std::array<std::array<uint8_t, 8>, 256> make_pixel_table() {
+        std::array<std::array<uint8_t, 8>, 256> table;
+        for (unsigned int value = 0; value < 256; ++value) {
+            for (unsigned int bit = 0; bit < 8; ++bit) {
+                table[value][bit] = (value >> (7 - bit)) & 1;
+            }
+        }
+        return table;
+    }
+
+    const std::array<std::array<uint8_t, 8>, 256> PIXELS = make_pixel_table();
+}
+
+VecEnv::VecEnv(const std::string &romPath, size_t envCount, unsigned int threadCount) : initial(new Chip8("VecEnv", true)),
+                                                                                         seeds(envCount, 0),
+                                                                                         episodeFrames(envCount, 0),
+                                                                                         scores(envCount, 0),
+                                                                                         pool(threadCount),
+                                                                                         frameCycles(11),
+                                                                                         maxEpisodeFrames(0),
+                                                                                         scoreAddress(-1) {
+    if (envCount == 0) {
+        throw std::runtime_error("VecEnv needs at least one environment");
+    }
+
+    this->initial->load_program(romPath);
+    this->initial->set_frame_cycles(this->frameCycles);
+
+    this->cores.resize(envCount);
+    for (size_t envId = 0; envId < envCount; ++envId) {
+        this->reset_env(envId, 0);
+    }
+}
+
+/// Starts a new episode in every environment, `seeds[envId]` seeding its random number generator
+void VecEnv::reset(const uint32_t *seeds, uint8_t *observations) {
+    this->pool.run(this->cores.size(), [this, seeds, observations](size_t envId) {
+        this->reset_env(envId, seeds[envId]);
+        this->write_observation(envId, observations);
+    });
+}
+
+/// Runs `framesPerStep` frames in every environment with `actions[envId]` held
+void VecEnv::step(const uint8_t *actions, unsigned int framesPerStep, uint8_t *observations, float *rewards, uint8_t *dones) {
+    this->pool.run(this->cores.size(), [this, actions, framesPerStep, observations, rewards, dones](size_t envId) {
+        Chip8 &core = *this->cores[envId];
+
+        uint8_t action = actions[envId];
+        core.set_keypad_state(action < 16 ? static_cast<uint16_t>(1 << action) : 0);
+
+        bool done = false;
+        try {
+            core.run_frames(framesPerStep);
+        } catch (const std::exception &) {
+            done = true; // Unsupported instruction : the episode can't go on
+        }
+
+        this->episodeFrames[envId] += framesPerStep;
+
+        float reward = 0;
+        if (this->scoreAddress >= 0) {
+            uint8_t score = core.get_memory_byte(static_cast<uint16_t>(this->scoreAddress));
+            reward = static_cast<float>(score) - static_cast<float>(this->scores[envId]);
+            this->scores[envId] = score;
+        }
+
+        done = done || core.is_halted() || (this->maxEpisodeFrames > 0 && this->episodeFrames[envId] >= this->maxEpisodeFrames);
+        if (done) {
+            this->reset_env(envId, this->seeds[envId] + 1);
+        }
+
+        rewards[envId] = reward;
+        dones[envId]   = done ? 1 : 0;
+        this->write_observation(envId, observations);
+    });
+}
+
+void VecEnv::set_frame_cycles(unsigned int frameCycles) {
+    this->frameCycles = frameCycles;
+    this->initial->set_frame_cycles(frameCycles);
+    for (size_t envId = 0; envId < this->cores.size(); ++envId) {
+        this->cores[envId]->set_frame_cycles(frameCycles);
+    }
+}
+
+void VecEnv::set_max_episode_frames(uint64_t maxEpisodeFrames) {
+    this->maxEpisodeFrames = maxEpisodeFrames;
+}
+
+void VecEnv::set_score_address(int scoreAddress) {
+    if (scoreAddress >= 4096) {
+        throw std::runtime_error("Invalid score address : " + std::to_string(scoreAddress));
+    }
+    this->scoreAddress = scoreAddress;
+
+    for (size_t envId = 0; envId < this->cores.size(); ++envId) { // Rewards count from now on
+        this->scores[envId] = scoreAddress >= 0 ? this->cores[envId]->get_memory_byte(static_cast<uint16_t>(scoreAddress)) : 0;
+    }
+}
+
+size_t VecEnv::size() const {
+    return this->cores.size();
+}
+
+unsigned int VecEnv::get_thread_count() const {
+    return this->pool.get_thread_count();
+}
+
+/// Fork of the freshly loaded core : environments share its memory pages until they write to them
+void VecEnv::reset_env(size_t envId, uint32_t seed) {
+    std::unique_ptr<Chip8> core = this->initial->fork();
+    core->set_random_seed(seed);
+
+    this->cores[envId].swap(core);
+    this->seeds[envId]         = seed;
+    this->episodeFrames[envId] = 0;
+    this->scores[envId]        = this->scoreAddress >= 0 ? this->cores[envId]->get_memory_byte(static_cast<uint16_t>(this->scoreAddress)) : 0;
+}
+
+void VecEnv::write_observation(size_t envId, uint8_t *observations) const {
+    DisplayView view   = this->cores[envId]->get_display_view();
+    uint8_t    *pixels = observations + envId * OBSERVATION_SIZE;
+
+    for (unsigned int y = 0; y < DisplayView::HEIGHT; ++y) {
+        uint64_t row = view.row(y);
+        for (unsigned int byteId = 0; byteId < 8; ++byteId) {
+            std::memcpy(pixels + y * DisplayView::WIDTH + byteId * 8, PIXELS[(row >> (56 - 8 * byteId)) & 0xFF].data(), 8);
+        }
+    }
+}
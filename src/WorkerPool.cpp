@@ -0,0 +1,100 @@
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+
+/// `threadCount` threads in total, the caller of `run()` included (0 : one per hardware thread)
+WorkerPool::WorkerPool(unsigned int threadCount) : task(NULL), taskCount(0), nextTask(0), busyWorkers(0),
+                                                   batch(0), stopping(false) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned int workerId = 1; workerId < threadCount; ++workerId) {
+        this->workers.push_back(std::thread(&WorkerPool::work, this));
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+
+    for (size_t workerId = 0; workerId < this->workers.size(); ++workerId) {
+        this->workers[workerId].join();
+    }
+}
+
+void WorkerPool::run(size_t taskCount, const Task &task) {
+    if (taskCount == 0) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->task        = &task;
+        this->taskCount   = taskCount;
+        this->busyWorkers = this->workers.size();
+        this->firstError  = std::exception_ptr();
+        this->nextTask.store(0);
+        ++this->batch;
+    }
+    this->wake.notify_all();
+
+    this->drain();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->done.wait(lock, [this]() { return this->busyWorkers == 0; });
+
+        this->task = NULL;
+        error      = this->firstError;
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+unsigned int WorkerPool::get_thread_count() const {
+    return static_cast<unsigned int>(this->workers.size() + 1);
+}
+
+void WorkerPool::work() {
+    uint64_t seenBatch = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->wake.wait(lock, [this, seenBatch]() { return this->stopping || this->batch != seenBatch; });
+
+            if (this->stopping) {
+                return;
+            }
+            seenBatch = this->batch;
+        }
+
+        this->drain();
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (--this->busyWorkers == 0) {
+            this->done.notify_one();
+        }
+    }
+}
+
+/// Runs tasks of the current batch until there are none left
+void WorkerPool::drain() {
+    for (size_t taskId = this->nextTask++; taskId < this->taskCount; taskId = this->nextTask++) {
+        try {
+            (*this->task)(taskId);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (!this->firstError) {
+                this->firstError = std::current_exception();
+            }
+        }
+    }
+}
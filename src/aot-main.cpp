@@ -0,0 +1,63 @@
+#include "RomCache.hpp"
+#include "RomRecompiler.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// Ahead-of-time recompiler : translates a `.ch8` file to a C++ unit that registers itself with
+// `RecompiledRomRegistry`. Link the unit into the emulator (see CHIP8PP_RECOMPILE_BUNDLED) or build
+// it as a shared library and load it with `chip8pp-headless --plugin`.
+
+namespace {
+    void print_usage(const char *program) {
+        std::fprintf(stderr, "Usage: %s <rom.ch8> <output.cpp>\n", program);
+    }
+
+    /// File name without directory nor extension
+    std::string title_of(const std::string &path) {
+        size_t start = path.find_last_of('/');
+        start = start == std::string::npos ? 0 : start + 1;
+
+        size_t end = path.find_last_of('.');
+        if (end == std::string::npos || end < start) {
+            end = path.size();
+        }
+        return path.substr(start, end - start);
+    }
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc != 3) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        std::shared_ptr<const RomImage> rom = RomCache::instance().load(argv[1]);
+        RomRecompiler recompiler(rom->bytes.data(), rom->bytes.size());
+
+        std::ostringstream source;
+        recompiler.emit(source, title_of(argv[1]));
+
+        // Written in one go, so that an interrupted run never leaves half a unit for the build to pick up
+        std::string temporary = std::string(argv[2]) + ".tmp";
+        std::ofstream output(temporary.c_str(), std::ios::binary | std::ios::trunc);
+        output << source.str();
+        output.close();
+
+        if (!output || std::rename(temporary.c_str(), argv[2]) != 0) {
+            throw std::runtime_error("Can't write `" + std::string(argv[2]) + "`");
+        }
+
+        std::fprintf(stderr, "%s : %zu blocks, %zu instructions, %zu computed jumps left to the interpreter\n",
+                     argv[1], recompiler.get_block_count(), recompiler.get_instruction_count(),
+                     recompiler.get_computed_jump_count());
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
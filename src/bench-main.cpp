@@ -0,0 +1,914 @@
+#include "Chip8.hpp"
+#include "FrameExporter.hpp"
+#include "GridRenderer.hpp"
+#include "Hash.hpp"
+#include "Metrics.hpp"
+#include "PerfCounterGroup.hpp"
+#include "RollbackSession.hpp"
+#include "TerminalRenderer.hpp"
+#include "VecEnv.hpp"
+
+#ifdef CHIP8PP_EGL
+#include "AsyncReadback.hpp"
+#include "MosaicRenderer.hpp"
+#include "OffscreenContext.hpp"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+// chip8-bench : micro (per opcode handler), macro (whole ROMs), environment, fork, rollback and rendering benchmarks.
+//
+// Results are printed as a table on stderr and as JSON on stdout (or `--json FILE`). With
+// `--baseline FILE`, every benchmark slower than the baseline by more than `--threshold` (a
+// fraction, 0.10 by default) is reported and the exit status is 1. With `--perf`, hardware counters
+// of the measured runs are added, per emulated instruction when the benchmark executes any.
+
+namespace {
+    /// Runs `iterations` units of work and returns how many operations were actually executed
+    typedef std::function<uint64_t(uint64_t iterations)> BenchmarkBody;
+
+    struct Benchmark {
+        std::string               name;            ///< `group/case`
+        BenchmarkBody             body;            ///< Measured work
+        std::shared_ptr<uint64_t> collapsedCycles; ///< Set by the body to the guest cycles fused waits skipped (NULL if untracked)
+    };
+
+    struct BenchmarkResult {
+        std::string name;            ///< Benchmark name
+        double      nsPerOp;         ///< Median time per operation
+        uint64_t    operations;      ///< Operations per measured run
+        bool        hasCollapsed;    ///< Whether the benchmark tracks `collapsedCycles`
+        uint64_t    collapsedCycles; ///< Guest cycles skipped by fused waits in the last measured run, not counted as operations
+        bool        hasCounters;     ///< Whether `counters` was measured (`--perf`)
+        bool        perInstruction;  ///< Whether `counters` is per emulated instruction, rather than per operation
+        PerfCounts  counters;        ///< Hardware counts of every measured run, per instruction or operation
+    };
+
+    struct Options {
+        std::string filter;    ///< Only run benchmarks whose name contains this
+        double      minTime;   ///< Minimum duration of one measured run, in seconds
+        unsigned    runs;      ///< Measured runs per benchmark (median is kept)
+        std::string jsonPath;  ///< Where to write JSON (`-` is stdout)
+        std::string baseline;  ///< Baseline JSON to compare with
+        double      threshold; ///< Allowed slowdown before a regression is reported
+        std::string romDirectory; ///< ROMs for the throughput benchmarks
+        bool        perf;      ///< Whether to read hardware counters around the measured runs
+    };
+
+    double seconds_since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // ---- Micro benchmarks -------------------------------------------------------------------
+
+    /**
+     * Program laid out as : setup instructions (run once), `body` repeated, then two jumps back to the
+     * repeated part (two, so that a skip on the last copy still loops), then `tail` (subroutines).
+     */
+    std::vector<uint8_t> make_loop_program(const std::vector<uint16_t> &setup, const std::vector<uint16_t> &body,
+                                           unsigned int copies, const std::vector<uint16_t> &tail) {
+        std::vector<uint16_t> words(setup);
+        uint16_t loopStart = static_cast<uint16_t>(0x200 + 2*setup.size());
+
+        for (unsigned int copy = 0; copy < copies; ++copy) {
+            words.insert(words.end(), body.begin(), body.end());
+        }
+        words.push_back(0x1000 | loopStart);
+        words.push_back(0x1000 | loopStart);
+        words.insert(words.end(), tail.begin(), tail.end());
+
+        std::vector<uint8_t> bytes;
+        for (size_t wordId = 0; wordId < words.size(); ++wordId) {
+            bytes.push_back(static_cast<uint8_t>(words[wordId] >> 8));
+            bytes.push_back(static_cast<uint8_t>(words[wordId] & 0xFF));
+        }
+        return bytes;
+    }
+
+    uint16_t tail_address(const std::vector<uint16_t> &setup, size_t bodySize, unsigned int copies) {
+        return static_cast<uint16_t>(0x200 + 2*(setup.size() + bodySize*copies + 2));
+    }
+
+    Benchmark opcode_benchmark(const std::string &name, const std::vector<uint16_t> &setup, const std::vector<uint16_t> &body,
+                               const std::vector<uint16_t> &tail = std::vector<uint16_t>(), unsigned int copies = 256) {
+        std::vector<uint8_t> program = make_loop_program(setup, body, copies, tail);
+
+        Benchmark benchmark;
+        benchmark.name = "opcode/" + name;
+        benchmark.body = [program, setup](uint64_t iterations) -> uint64_t {
+            Chip8 emulator("Bench", true);
+            emulator.load_program(program.data(), program.size());
+
+            for (size_t setupId = 0; setupId < setup.size(); ++setupId) {
+                emulator.step();
+            }
+
+            for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                emulator.step();
+            }
+            return iterations;
+        };
+        return benchmark;
+    }
+
+    void add_opcode_benchmarks(std::vector<Benchmark> &benchmarks) {
+        const std::vector<uint16_t> none;
+        const std::vector<uint16_t> registers = {0x6005, 0x6107, 0x6203, 0x6F00}; // V0=5, V1=7, V2=3
+
+        benchmarks.push_back(opcode_benchmark("00E0_CLS",   none,      {0x00E0}));
+        benchmarks.push_back(opcode_benchmark("1NNN_JP",    none,      {0x1200}, none, 1));
+        benchmarks.push_back(opcode_benchmark("3XNN_SE",    registers, {0x3005}));
+        benchmarks.push_back(opcode_benchmark("4XNN_SNE",   registers, {0x4005}));
+        benchmarks.push_back(opcode_benchmark("5XY0_SE",    registers, {0x5010}));
+        benchmarks.push_back(opcode_benchmark("6XNN_LD",    none,      {0x6A42}));
+        benchmarks.push_back(opcode_benchmark("7XNN_ADD",   none,      {0x7A01}));
+        benchmarks.push_back(opcode_benchmark("8XY0_LD",    registers, {0x8010}));
+        benchmarks.push_back(opcode_benchmark("8XY1_OR",    registers, {0x8211}));
+        benchmarks.push_back(opcode_benchmark("8XY4_ADD",   registers, {0x8214}));
+        benchmarks.push_back(opcode_benchmark("8XY5_SUB",   registers, {0x8215}));
+        benchmarks.push_back(opcode_benchmark("8XY6_SHR",   registers, {0x8216}));
+        benchmarks.push_back(opcode_benchmark("8XYE_SHL",   registers, {0x821E}));
+        benchmarks.push_back(opcode_benchmark("9XY0_SNE",   registers, {0x9010}));
+        benchmarks.push_back(opcode_benchmark("ANNN_LD_I",  none,      {0xA050}));
+        benchmarks.push_back(opcode_benchmark("CXNN_RND",   none,      {0xC0FF}));
+        benchmarks.push_back(opcode_benchmark("EX9E_SKP",   registers, {0xE09E}));
+        benchmarks.push_back(opcode_benchmark("EXA1_SKNP",  registers, {0xE0A1}));
+        benchmarks.push_back(opcode_benchmark("FX07_LD_DT", none,      {0xF007}));
+        benchmarks.push_back(opcode_benchmark("FX0A_WAIT",  none,      {0xF00A}, none, 1));
+        benchmarks.push_back(opcode_benchmark("FX15_DT",    registers, {0xF015}));
+        benchmarks.push_back(opcode_benchmark("FX1E_ADD_I", {0x6000},  {0xF01E}));
+        benchmarks.push_back(opcode_benchmark("FX29_FONT",  registers, {0xF029}));
+        benchmarks.push_back(opcode_benchmark("FX33_BCD",   {0x60FE, 0xA900}, {0xF033}));
+        benchmarks.push_back(opcode_benchmark("FX55_STORE", {0xA900}, {0xFF55}));
+        benchmarks.push_back(opcode_benchmark("FX65_LOAD",  {0xA900}, {0xFF65}));
+
+        // CALL + RET pairs : every copy calls the RET placed after the loop
+        std::vector<uint16_t> callSetup;
+        uint16_t subroutine = tail_address(callSetup, 1, 256);
+        benchmarks.push_back(opcode_benchmark("2NNN_00EE_CALL_RET", callSetup, {static_cast<uint16_t>(0x2000 | subroutine)}, {0x00EE}));
+
+        // DXYN at several sprite sizes and positions (aligned, unaligned, clipped at the right and bottom edges)
+        struct DrawCase { const char *name; uint8_t x; uint8_t y; uint8_t rows; };
+        const DrawCase drawCases[] = {
+            {"DXY1_x0",     0,  0, 1},
+            {"DXY5_x0",     0,  0, 5},
+            {"DXY5_x3",     3,  4, 5},
+            {"DXYF_x0",     0,  0, 15},
+            {"DXYF_x29",   29,  8, 15},
+            {"DXYF_clip", 60, 24, 15}
+        };
+
+        for (size_t caseId = 0; caseId < sizeof(drawCases)/sizeof(drawCases[0]); ++caseId) {
+            const DrawCase &drawCase = drawCases[caseId];
+            std::vector<uint16_t> setup = {static_cast<uint16_t>(0x6000 | drawCase.x), static_cast<uint16_t>(0x6100 | drawCase.y), 0xA050};
+            benchmarks.push_back(opcode_benchmark(drawCase.name, setup, {static_cast<uint16_t>(0xD010 | drawCase.rows)}));
+        }
+    }
+
+    // ---- ROM throughput ---------------------------------------------------------------------
+
+    void add_rom_benchmarks(std::vector<Benchmark> &benchmarks, const std::string &directory) {
+        static const uint64_t ROM_FRAME_CYCLES = 11; ///< `Chip8`'s default instructions per frame
+        DIR *handle = ::opendir(directory.c_str());
+        if (handle == NULL) {
+            std::cerr << "No ROM directory at `" << directory << "`, skipping ROM benchmarks\n";
+            return;
+        }
+
+        std::vector<std::string> names;
+        while (struct dirent *item = ::readdir(handle)) {
+            std::string name = item->d_name;
+            if (name.size() > 4 && name.compare(name.size() - 4, 4, ".ch8") == 0) {
+                names.push_back(name);
+            }
+        }
+        ::closedir(handle);
+        std::sort(names.begin(), names.end());
+
+        for (size_t nameId = 0; nameId < names.size(); ++nameId) {
+            std::string path  = directory + "/" + names[nameId];
+            std::string title = names[nameId].substr(0, names[nameId].size() - 4);
+            std::replace(title.begin(), title.end(), ' ', '_');
+
+            // `rom/` steps instructions one by one (no timers), as before fusion existed
+            Benchmark stepped;
+            stepped.name = "rom/" + title;
+            stepped.body = [path](uint64_t iterations) -> uint64_t {
+                Chip8 emulator("Bench", true);
+                emulator.load_program(path);
+
+                uint64_t executed = 0;
+                try {
+                    for (; executed < iterations; ++executed) {
+                        emulator.step();
+                    }
+                } catch (const std::exception &) {
+                    // Unsupported opcode : only the instructions executed so far are counted
+                }
+                return executed;
+            };
+            benchmarks.push_back(stepped);
+
+            // `rom_fused/` runs frames like the emulator does, timers included, and `rom_unfused/` the same frames
+            // instruction by instruction. Cycles collapsed by idle jumps and delay waits aren't operations : only
+            // instructions actually run are, so the gain of fusion can't come from skipped waits
+            for (int fusion = 1; fusion >= 0; --fusion) {
+                std::shared_ptr<uint64_t> collapsed = std::make_shared<uint64_t>(0);
+
+                Benchmark benchmark;
+                benchmark.name            = (fusion ? "rom_fused/" : "rom_unfused/") + title;
+                benchmark.collapsedCycles = collapsed;
+                benchmark.body = [path, fusion, collapsed](uint64_t iterations) -> uint64_t {
+                    Chip8 emulator("Bench", true);
+                    emulator.set_fusion_enabled(fusion != 0);
+                    emulator.load_program(path);
+
+                    uint64_t frames = std::max<uint64_t>(1, iterations / ROM_FRAME_CYCLES);
+                    try {
+                        for (uint64_t frame = 0; frame < frames; ++frame) {
+                            emulator.run_frames(1);
+                        }
+                    } catch (const std::exception &) {
+                        // Unsupported opcode : only the instructions executed so far are counted
+                    }
+
+                    *collapsed = emulator.get_collapsed_cycles();
+                    return emulator.get_instruction_count() - emulator.get_collapsed_cycles();
+                };
+                benchmarks.push_back(benchmark);
+            }
+        }
+    }
+
+    // ---- Reinforcement learning environments ---------------------------------------------------
+
+    struct EnvBench {
+        VecEnv               env;          ///< Environments under test
+        std::vector<uint8_t> actions;      ///< Same key everywhere
+        std::vector<uint8_t> observations; ///< Observation buffer
+        std::vector<float>   rewards;      ///< Reward buffer
+        std::vector<uint8_t> dones;        ///< Episode end buffer
+
+        EnvBench(const std::string &path, size_t envCount) : env(path, envCount), actions(envCount, 5),
+                                                             observations(envCount * VecEnv::OBSERVATION_SIZE),
+                                                             rewards(envCount), dones(envCount) {}
+    };
+
+    void add_env_benchmarks(std::vector<Benchmark> &benchmarks, const std::string &directory) {
+        static const size_t       ENV_COUNTS[2]   = {1, 256};
+        static const unsigned int FRAMES_PER_STEP = 4;
+
+        std::string path = directory + "/Particle Demo [zeroZshadow, 2008].ch8";
+        if (!std::ifstream(path)) {
+            std::cerr << "No `" << path << "`, skipping environment benchmarks\n";
+            return;
+        }
+
+        // One operation is one environment step; the batch is built on first use so that filtered
+        // out benchmarks don't start worker threads
+        for (size_t countId = 0; countId < 2; ++countId) {
+            size_t                    envCount = ENV_COUNTS[countId];
+            std::shared_ptr<EnvBench> bench;
+
+            Benchmark benchmark;
+            benchmark.name = "env/step_" + std::to_string(envCount);
+            benchmark.body = [path, envCount, bench](uint64_t iterations) mutable -> uint64_t {
+                if (!bench) {
+                    bench = std::make_shared<EnvBench>(path, envCount);
+                }
+
+                uint64_t steps = (iterations + envCount - 1) / envCount;
+                for (uint64_t step = 0; step < steps; ++step) {
+                    bench->env.step(bench->actions.data(), FRAMES_PER_STEP, bench->observations.data(),
+                                    bench->rewards.data(), bench->dones.data());
+                }
+                return steps * envCount;
+            };
+            benchmarks.push_back(benchmark);
+        }
+    }
+
+    // ---- Forks --------------------------------------------------------------------------------
+
+    void add_fork_benchmarks(std::vector<Benchmark> &benchmarks, const std::string &directory) {
+        static const unsigned int WARM_UP_FRAMES = 120; ///< Frames run by the root before it's forked
+        static const size_t       BRANCH_DEPTH   = 64;  ///< Forks chained before starting over from the root
+
+        std::string path = directory + "/Particle Demo [zeroZshadow, 2008].ch8";
+        if (!std::ifstream(path)) {
+            std::cerr << "No `" << path << "`, skipping fork benchmarks\n";
+            return;
+        }
+
+        std::shared_ptr<Chip8> root = std::make_shared<Chip8>("Bench", true);
+        root->load_program(path);
+        root->run_frames(WARM_UP_FRAMES);
+
+        // Fork only : one operation is one fork, released right away
+        Benchmark fork;
+        fork.name = "fork/fork";
+        fork.body = [root](uint64_t iterations) -> uint64_t {
+            for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                std::unique_ptr<Chip8> child = root->fork();
+            }
+            return iterations;
+        };
+        benchmarks.push_back(fork);
+
+        // Deep branching : every operation forks the deepest core and runs one frame on the fork
+        Benchmark branch;
+        branch.name = "fork/branch_frame";
+        branch.body = [root](uint64_t iterations) -> uint64_t {
+            std::vector<std::unique_ptr<Chip8>> branchPath;
+            branchPath.reserve(BRANCH_DEPTH);
+
+            for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                if (branchPath.size() == BRANCH_DEPTH) {
+                    branchPath.clear();
+                }
+
+                std::unique_ptr<Chip8> child = (branchPath.empty() ? *root : *branchPath.back()).fork();
+                child->set_keypad_state(static_cast<uint16_t>(1 << (iteration % 16)));
+                child->run_frames(1);
+                branchPath.push_back(std::move(child));
+            }
+            return iterations;
+        };
+        benchmarks.push_back(branch);
+
+        // Same frames on a single core, to tell the cost of forking from the emulation
+        Benchmark frame;
+        frame.name = "fork/frame";
+        frame.body = [root](uint64_t iterations) -> uint64_t {
+            std::unique_ptr<Chip8> core = root->fork();
+            for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                core->set_keypad_state(static_cast<uint16_t>(1 << (iteration % 16)));
+                core->run_frames(1);
+            }
+            return iterations;
+        };
+        benchmarks.push_back(frame);
+    }
+
+    // ---- Rollback netcode -----------------------------------------------------------------------
+
+    /**
+     * Two sessions wired back to back, every packet arriving `lag` frames after it was written. One
+     * operation is one frame on both peers. With `changingKeys`, both players press another key every
+     * frame, so every remote input is mispredicted and every frame rolls `lag` frames back.
+     */
+    BenchmarkBody rollback_body(std::shared_ptr<Chip8> root, unsigned int lag, bool changingKeys) {
+        return [root, lag, changingKeys](uint64_t iterations) -> uint64_t {
+            RollbackSession  first(*root, lag + 1);
+            RollbackSession  second(*root, lag + 1);
+            RollbackSession *sessions[2] = {&first, &second};
+
+            std::deque<std::pair<uint64_t, std::vector<uint8_t>>> inFlight[2]; // Packets toward each side, with their arrival
+            uint8_t packet[RollbackSession::MAX_PACKET_SIZE];
+
+            for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                for (unsigned int side = 0; side < 2; ++side) {
+                    while (!inFlight[side].empty() && inFlight[side].front().first <= iteration) {
+                        sessions[side]->read_packet(inFlight[side].front().second.data(), inFlight[side].front().second.size());
+                        inFlight[side].pop_front();
+                    }
+
+                    unsigned int key = static_cast<unsigned int>(changingKeys ? iteration + 8*side : 8*side) % 16;
+                    sessions[side]->advance(static_cast<uint16_t>(1 << key));
+
+                    size_t size = sessions[side]->write_packet(packet);
+                    inFlight[1 - side].push_back(std::make_pair(iteration + lag, std::vector<uint8_t>(packet, packet + size)));
+                }
+            }
+            return iterations;
+        };
+    }
+
+    void add_rollback_benchmarks(std::vector<Benchmark> &benchmarks, const std::string &directory) {
+        static const unsigned int WARM_UP_FRAMES = 120; ///< Frames run by the root before the sessions start
+        static const unsigned int LAG_FRAMES     = 8;   ///< Packet latency (133 ms at 60 frames per second)
+
+        std::string path = directory + "/Particle Demo [zeroZshadow, 2008].ch8";
+        if (!std::ifstream(path)) {
+            std::cerr << "No `" << path << "`, skipping rollback benchmarks\n";
+            return;
+        }
+
+        std::shared_ptr<Chip8> root = std::make_shared<Chip8>("Bench", true);
+        root->load_program(path);
+        root->run_frames(WARM_UP_FRAMES);
+
+        // Desync detection cost, paid once per confirmed frame
+        Benchmark stateHash;
+        stateHash.name = "rollback/state_hash";
+        stateHash.body = [root](uint64_t iterations) -> uint64_t {
+            uint64_t hash = 0;
+            for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                hash ^= root->get_state_hash();
+            }
+            return hash == 1 ? iterations + 1 : iterations; // Keeps the loop from being optimized away
+        };
+        benchmarks.push_back(stateHash);
+
+        // Predictions always right : snapshots and hashes only
+        Benchmark steady;
+        steady.name = "rollback/frame_steady";
+        steady.body = rollback_body(root, LAG_FRAMES, false);
+        benchmarks.push_back(steady);
+
+        // Predictions always wrong : restore and `LAG_FRAMES` frames simulated again on each peer every frame
+        Benchmark mispredicted;
+        mispredicted.name = "rollback/frame_lag8";
+        mispredicted.body = rollback_body(root, LAG_FRAMES, true);
+        benchmarks.push_back(mispredicted);
+    }
+
+    // ---- Rendering ----------------------------------------------------------------------------
+
+    std::vector<std::array<uint64_t, 32>> make_test_frames() {
+        std::vector<std::array<uint64_t, 32>> frames(2);
+        for (unsigned int y = 0; y < 32; ++y) {
+            frames[0][y] = 0x0123456789ABCDEFULL * (y + 1);
+            frames[1][y] = ~frames[0][y] ^ (0xF0F0F0F0ULL << (y % 32));
+        }
+        return frames;
+    }
+
+    void add_render_benchmarks(std::vector<Benchmark> &benchmarks) {
+        std::vector<std::array<uint64_t, 32>> frames = make_test_frames();
+
+        Benchmark hash;
+        hash.name = "render/frame_hash";
+        hash.body = [frames](uint64_t iterations) -> uint64_t {
+            uint64_t accumulator = 0;
+            for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                accumulator += xxhash64_words(frames[iteration & 1].data(), 32, accumulator);
+            }
+            return iterations + (accumulator == 42 ? 1 : 0); // Keeps the loop from being optimized out
+        };
+        benchmarks.push_back(hash);
+
+        Benchmark terminal;
+        terminal.name = "render/terminal_diff";
+        terminal.body = [frames](uint64_t iterations) -> uint64_t {
+            int sink = ::open("/dev/null", O_WRONLY);
+            {
+                TerminalRenderer renderer(sink);
+                for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                    DisplayView view = {frames[iteration & 1].data(), 1, iteration};
+                    renderer.render(view);
+                }
+            }
+            ::close(sink);
+            return iterations;
+        };
+        benchmarks.push_back(terminal);
+
+        Benchmark exporter;
+        exporter.name = "render/y4m_export_x8";
+        exporter.body = [frames](uint64_t iterations) -> uint64_t {
+            FrameExporter output("/dev/null", FrameExporter::Format::Y4M, 8);
+            for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                DisplayView view = {frames[iteration & 1].data(), 1, iteration};
+                output.wait_for_slot();
+                output.submit(view, iteration);
+            }
+            output.finish();
+            return iterations;
+        };
+        benchmarks.push_back(exporter);
+    }
+
+#ifdef CHIP8PP_EGL
+    /// Offscreen context and renderer shared by the `gl/` benchmarks, so their setup isn't measured
+    struct GlBench {
+        OffscreenContext     context;  ///< EGL context and render target
+        GridRenderer         renderer; ///< Same renderer as the window
+        std::vector<uint8_t> pixels;   ///< Readback destination
+
+        GlBench() : context(64*8, 32*8), renderer(), pixels(context.get_frame_size()) {}
+    };
+
+    void add_gl_benchmarks(std::vector<Benchmark> &benchmarks, const std::string &filter) {
+        static const char *const NAMES[6] = {"gl/submit", "gl/frame", "gl/frame_readback", "gl/frame_readback_async",
+                                             "gl/mosaic_1", "gl/mosaic_256"};
+
+        bool selected = false;
+        for (size_t nameId = 0; nameId < 6; ++nameId) {
+            selected = selected || std::string(NAMES[nameId]).find(filter) != std::string::npos;
+        }
+        if (!selected) {
+            return;
+        }
+
+        std::shared_ptr<GlBench> bench;
+        try {
+            bench = std::make_shared<GlBench>();
+        } catch (const std::exception &error) {
+            std::cerr << error.what() << ", skipping OpenGL benchmarks\n";
+            return;
+        }
+        std::cerr << "OpenGL benchmarks on " << bench->context.get_renderer_name() << "\n";
+
+        std::vector<std::array<uint64_t, 32>> frames = make_test_frames();
+
+        // Draw calls only : the driver queue is drained once per run
+        Benchmark submit;
+        submit.name = NAMES[0];
+        submit.body = [bench, frames](uint64_t iterations) -> uint64_t {
+            for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                DisplayView view = {frames[iteration & 1].data(), 1, iteration};
+                bench->renderer.draw(view);
+                glFlush();
+            }
+            glFinish();
+            return iterations;
+        };
+        benchmarks.push_back(submit);
+
+        // Full frame time : submission and rasterization
+        Benchmark frame;
+        frame.name = NAMES[1];
+        frame.body = [bench, frames](uint64_t iterations) -> uint64_t {
+            for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                DisplayView view = {frames[iteration & 1].data(), 1, iteration};
+                bench->renderer.draw(view);
+                glFinish();
+            }
+            return iterations;
+        };
+        benchmarks.push_back(frame);
+
+        // Full frame time with a synchronous `glReadPixels()` of the render target
+        Benchmark readback;
+        readback.name = NAMES[2];
+        readback.body = [bench, frames](uint64_t iterations) -> uint64_t {
+            for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                DisplayView view = {frames[iteration & 1].data(), 1, iteration};
+                bench->renderer.draw(view);
+                bench->context.read_pixels(bench->pixels.data());
+            }
+            return iterations;
+        };
+        benchmarks.push_back(readback);
+
+        // Same, through the pixel-pack buffer ring : frames are consumed a couple of frames later
+        Benchmark asyncReadback;
+        asyncReadback.name = NAMES[3];
+        asyncReadback.body = [bench, frames](uint64_t iterations) -> uint64_t {
+            uint64_t checksum = 0;
+            AsyncReadback readback(bench->context.get_width(), bench->context.get_height(),
+                                   [&checksum](const uint8_t *rgba, size_t size, uint64_t) { checksum += rgba[size / 2]; });
+
+            for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                DisplayView view = {frames[iteration & 1].data(), 1, iteration};
+                bench->renderer.draw(view);
+                readback.capture(iteration);
+            }
+            readback.flush();
+            return iterations + (checksum == 42 ? 1 : 0); // Keeps the consumer from being optimized out
+        };
+        benchmarks.push_back(asyncReadback);
+
+        // Mosaic frames where 4 displays change per frame (all of them with a single instance)
+        const size_t mosaicSizes[2] = {1, 256};
+        for (size_t sizeId = 0; sizeId < 2; ++sizeId) {
+            size_t instanceCount = mosaicSizes[sizeId];
+
+            Benchmark mosaic;
+            mosaic.name = NAMES[4 + sizeId];
+            mosaic.body = [bench, frames, instanceCount](uint64_t iterations) -> uint64_t {
+                MosaicRenderer renderer(instanceCount);
+                std::vector<DisplayView> views(instanceCount);
+
+                for (size_t instance = 0; instance < instanceCount; ++instance) {
+                    DisplayView view = {frames[instance & 1].data(), 1, 0};
+                    views[instance] = view;
+                }
+
+                for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                    for (size_t change = 0; change < 4; ++change) {
+                        DisplayView &view = views[(iteration * 4 + change) % instanceCount];
+                        view.rows = frames[(iteration + change) & 1].data();
+                        ++view.generation;
+                    }
+
+                    renderer.draw(views.data());
+                    glFinish();
+                }
+                return iterations;
+            };
+            benchmarks.push_back(mosaic);
+        }
+    }
+#endif
+
+    // ---- Measurement and reporting ------------------------------------------------------------
+
+    /// Instructions the cores of this thread ran and reported, without those fused waits skipped
+    uint64_t executed_instructions() {
+        MetricsShard &metrics = Metrics::local();
+        return metrics.instructions.load(std::memory_order_relaxed) - metrics.collapsedCycles.load(std::memory_order_relaxed);
+    }
+
+    /// Measures `benchmark`, and reads `counters` around its measured runs unless it's NULL
+    BenchmarkResult measure(const Benchmark &benchmark, const Options &options, PerfCounterGroup *counters) {
+        // Calibration : grow the iteration count until one run lasts at least `minTime`
+        uint64_t iterations = 64;
+        while (true) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            benchmark.body(iterations);
+            double elapsed = seconds_since(start);
+
+            if (elapsed >= options.minTime || iterations >= (1ULL << 40)) {
+                break;
+            }
+            double factor = elapsed > 0 ? 1.2 * options.minTime / elapsed : 16.0;
+            iterations = static_cast<uint64_t>(iterations * std::min(16.0, std::max(2.0, factor)));
+        }
+
+        std::vector<double> samples;
+        uint64_t operations = 0;
+
+        PerfCounts totals          = PerfCounts();
+        uint64_t   totalOperations = 0;
+        uint64_t   instructions    = 0; // Run by the cores of this thread, like the counters only cover this thread
+
+        for (unsigned int run = 0; run < options.runs; ++run) {
+            uint64_t reported = executed_instructions();
+            if (counters != NULL) {
+                counters->start();
+            }
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            operations = benchmark.body(iterations);
+            double elapsed = seconds_since(start);
+
+            if (counters != NULL) {
+                PerfCounts runCounts = counters->stop();
+                for (size_t counter = 0; counter < PerfCounterGroup::COUNTER_COUNT; ++counter) {
+                    totals.values[counter]   += runCounts.values[counter];
+                    totals.available[counter] = runCounts.available[counter];
+                }
+            }
+            instructions    += executed_instructions() - reported;
+            totalOperations += operations;
+
+            samples.push_back(operations > 0 ? 1e9 * elapsed / operations : 0.0);
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        BenchmarkResult result;
+        result.name            = benchmark.name;
+        result.nsPerOp         = samples[samples.size() / 2];
+        result.operations      = operations;
+        result.hasCollapsed    = benchmark.collapsedCycles != NULL;
+        result.collapsedCycles = result.hasCollapsed ? *benchmark.collapsedCycles : 0;
+        result.hasCounters     = counters != NULL;
+        result.perInstruction  = instructions > 0;
+        result.counters        = totals;
+
+        double units = static_cast<double>(instructions > 0 ? instructions : totalOperations);
+        for (size_t counter = 0; counter < PerfCounterGroup::COUNTER_COUNT; ++counter) {
+            result.counters.values[counter] = units > 0 ? totals.values[counter] / units : 0.0;
+        }
+        return result;
+    }
+
+    /// `perf stat`-like summary of the counters of a result, for the table
+    std::string format_counters(const BenchmarkResult &result) {
+        const PerfCounts &counts = result.counters;
+        std::ostringstream text;
+        text.setf(std::ios::fixed);
+        text.precision(2);
+
+        text << "  IPC ";
+        if (counts.values[PerfCounterGroup::CYCLES] > 0 && counts.available[PerfCounterGroup::INSTRUCTIONS]) {
+            text << counts.values[PerfCounterGroup::INSTRUCTIONS] / counts.values[PerfCounterGroup::CYCLES];
+        } else {
+            text << "-";
+        }
+
+        text << (result.perInstruction ? "  per insn :" : "  per op :");
+        for (size_t counter = 0; counter < PerfCounterGroup::COUNTER_COUNT; ++counter) {
+            text << ' ';
+            if (counts.available[counter]) {
+                text << counts.values[counter];
+            } else {
+                text << '-';
+            }
+            text << ' ' << PerfCounterGroup::COUNTER_NAMES[counter];
+        }
+        return text.str();
+    }
+
+    std::string to_json(const std::vector<BenchmarkResult> &results) {
+        std::ostringstream json;
+        json.precision(6);
+        json << "{\n  \"optimized\": " <<
+#ifdef __OPTIMIZE__
+            "true"
+#else
+            "false"
+#endif
+            << ",\n  \"benchmarks\": [\n";
+
+        for (size_t resultId = 0; resultId < results.size(); ++resultId) {
+            const BenchmarkResult &result = results[resultId];
+            json << "    {\"name\": \"" << result.name << "\", \"ns_per_op\": " << result.nsPerOp
+                 << ", \"ops_per_second\": " << (result.nsPerOp > 0 ? 1e9 / result.nsPerOp : 0.0)
+                 << ", \"operations\": " << result.operations;
+
+            if (result.hasCollapsed) {
+                json << ", \"collapsed_cycles\": " << result.collapsedCycles;
+            }
+
+            if (result.hasCounters) { // Same line : `load_baseline()` reads one benchmark per line
+                static const char *const KEYS[PerfCounterGroup::COUNTER_COUNT] = {"cycles", "instructions", "branch_misses", "l1d_misses"};
+
+                json << ", \"counters\": {\"per\": \"" << (result.perInstruction ? "instruction" : "op") << "\"";
+                for (size_t counter = 0; counter < PerfCounterGroup::COUNTER_COUNT; ++counter) {
+                    json << ", \"" << KEYS[counter] << "\": ";
+                    if (result.counters.available[counter]) {
+                        json << result.counters.values[counter];
+                    } else {
+                        json << "null";
+                    }
+                }
+                json << "}";
+            }
+            json << "}" << (resultId + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        json << "  ]\n}\n";
+        return json.str();
+    }
+
+    /// Reads back `name` -> `ns_per_op` from a file written by `to_json()`
+    std::map<std::string, double> load_baseline(const std::string &fileName) {
+        std::ifstream file(fileName);
+        if (!file.is_open()) {
+            throw std::runtime_error("Baseline file not found : `" + fileName + "`");
+        }
+
+        std::map<std::string, double> baseline;
+        std::string line;
+
+        while (std::getline(file, line)) {
+            size_t nameStart = line.find("\"name\": \"");
+            size_t timeStart = line.find("\"ns_per_op\": ");
+            if (nameStart == std::string::npos || timeStart == std::string::npos) {
+                continue;
+            }
+
+            nameStart += 9;
+            std::string name = line.substr(nameStart, line.find('"', nameStart) - nameStart);
+            baseline[name] = std::strtod(line.c_str() + timeStart + 13, NULL);
+        }
+
+        return baseline;
+    }
+
+    void print_usage(const char *program) {
+        std::fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --filter TEXT      Only run benchmarks whose name contains TEXT\n"
+            "  --min-time SEC     Minimum duration of a measured run (default 0.1)\n"
+            "  --runs N           Measured runs per benchmark, median is kept (default 5)\n"
+            "  --json FILE        Write results to FILE instead of stdout\n"
+            "  --baseline FILE    Compare with a previous JSON result\n"
+            "  --threshold F      Allowed slowdown fraction before failing (default 0.10)\n"
+            "  --roms DIR         ROM directory (default resources/chipPrograms)\n"
+            "  --perf             Read cycles, instructions, branch and L1d misses around the runs (Linux)\n",
+            program);
+    }
+}
+
+int main(int argc, char const *argv[]) {
+    Options options;
+    options.minTime      = 0.1;
+    options.runs         = 5;
+    options.jsonPath     = "-";
+    options.threshold    = 0.10;
+    options.romDirectory = "resources/chipPrograms";
+    options.perf         = false;
+
+    for (int argId = 1; argId < argc; ++argId) {
+        std::string arg = argv[argId];
+        bool hasValue = argId+1 < argc;
+
+        if (arg == "--filter" && hasValue) {
+            options.filter = argv[++argId];
+        } else if (arg == "--min-time" && hasValue) {
+            options.minTime = std::strtod(argv[++argId], NULL);
+        } else if (arg == "--runs" && hasValue) {
+            options.runs = std::max(1, std::atoi(argv[++argId]));
+        } else if (arg == "--json" && hasValue) {
+            options.jsonPath = argv[++argId];
+        } else if (arg == "--baseline" && hasValue) {
+            options.baseline = argv[++argId];
+        } else if (arg == "--threshold" && hasValue) {
+            options.threshold = std::strtod(argv[++argId], NULL);
+        } else if (arg == "--roms" && hasValue) {
+            options.romDirectory = argv[++argId];
+        } else if (arg == "--perf") {
+            options.perf = true;
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+#ifndef __OPTIMIZE__
+    std::cerr << "WARNING: chip8-bench was built without optimizations, numbers won't be representative\n";
+#endif
+
+    std::vector<Benchmark> benchmarks;
+    add_opcode_benchmarks(benchmarks);
+    add_rom_benchmarks(benchmarks, options.romDirectory);
+    add_env_benchmarks(benchmarks, options.romDirectory);
+    add_fork_benchmarks(benchmarks, options.romDirectory);
+    add_rollback_benchmarks(benchmarks, options.romDirectory);
+    add_render_benchmarks(benchmarks);
+#ifdef CHIP8PP_EGL
+    add_gl_benchmarks(benchmarks, options.filter);
+#endif
+
+    std::unique_ptr<PerfCounterGroup> counters;
+    if (options.perf) {
+        try {
+            counters.reset(new PerfCounterGroup());
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << ", measuring without hardware counters\n";
+        }
+    }
+
+    std::map<std::string, double> baseline;
+    if (!options.baseline.empty()) {
+        baseline = load_baseline(options.baseline);
+    }
+
+    std::vector<BenchmarkResult> results;
+    unsigned int regressions = 0;
+
+    for (size_t benchmarkId = 0; benchmarkId < benchmarks.size(); ++benchmarkId) {
+        if (benchmarks[benchmarkId].name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        BenchmarkResult result = measure(benchmarks[benchmarkId], options, counters.get());
+        results.push_back(result);
+
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-36s %10.2f ns/op", result.name.c_str(), result.nsPerOp);
+        std::cerr << line;
+
+        std::map<std::string, double>::const_iterator reference = baseline.find(result.name);
+        if (reference != baseline.end() && reference->second > 0) {
+            double change = result.nsPerOp / reference->second - 1.0;
+            bool   regressed = change > options.threshold;
+
+            std::snprintf(line, sizeof(line), "  %+7.1f%% vs baseline%s", 100.0 * change, regressed ? "  REGRESSION" : "");
+            std::cerr << line;
+            regressions += regressed ? 1 : 0;
+        }
+        if (result.hasCollapsed && result.collapsedCycles > 0) {
+            std::cerr << "  (" << result.collapsedCycles << " cycles collapsed)";
+        }
+        if (result.hasCounters) {
+            std::cerr << format_counters(result);
+        }
+        std::cerr << "\n";
+    }
+
+    std::string json = to_json(results);
+    if (options.jsonPath == "-") {
+        std::cout << json;
+    } else {
+        std::ofstream output(options.jsonPath);
+        output << json;
+    }
+
+    if (regressions > 0) {
+        std::cerr << regressions << " benchmark(s) regressed by more than " << 100.0 * options.threshold << "%\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "RomCorpus.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+// Corpus tool : packs a directory of `.ch8` files into a `.c8pack` corpus, or lists one.
+
+namespace {
+    void print_usage(const char *program) {
+        std::fprintf(stderr,
+            "Usage: %s build <rom directory> <output.c8pack> [--threads N]\n"
+            "       %s list <corpus.c8pack>\n",
+            program, program);
+    }
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::string command = argv[1];
+
+    try {
+        if (command == "build" && argc >= 4) {
+            unsigned int threadCount = std::thread::hardware_concurrency();
+            if (argc >= 6 && std::string(argv[4]) == "--threads") {
+                threadCount = static_cast<unsigned int>(std::strtoul(argv[5], NULL, 10));
+            }
+
+            size_t romCount = build_rom_corpus(argv[2], argv[3], threadCount);
+            std::printf("Packed %zu distinct ROMs into %s\n", romCount, argv[3]);
+        } else if (command == "list") {
+            RomCorpus corpus(argv[2]);
+
+            for (size_t entryId = 0; entryId < corpus.size(); ++entryId) {
+                CorpusRom rom = corpus.at(entryId);
+                std::printf("%016llx %6u %-9s quirks=%x  %s\n",
+                            (unsigned long long)rom.entry->hash, rom.entry->size,
+                            get_platform_name(static_cast<RomPlatform>(rom.entry->platform)),
+                            rom.entry->quirks, rom.title.c_str());
+            }
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,282 @@
+#include "Chip8.hpp"
+#include "FrameExporter.hpp"
+#include "Metrics.hpp"
+#include "MetricsServer.hpp"
+#include "RomCorpus.hpp"
+#include "TerminalRenderer.hpp"
+#include "Timeline.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// Headless runner : executes a ROM without any window and prints display hashes, so that
+// regression suites can compare them against stored golden values.
+//
+// Output lines are `<cycle> <frame> <hash>` with the hash as 16 hex digits. They go to stderr
+// instead of stdout when frames are exported or drawn to stdout.
+
+namespace {
+    void print_usage(const char *program) {
+        std::fprintf(stderr,
+            "Usage: %s <rom> [options]\n"
+            "  --corpus FILE     Take <rom> as a title or hash in a .c8pack corpus\n"
+            "  --cycles N        Number of instructions to execute (default 10000)\n"
+            "  --frame-cycles N  Instructions per emulated frame (default 11)\n"
+            "  --every-frame     Print the display hash after each frame\n"
+            "  --at C1,C2,...    Print the display hash after the given cycle counts\n"
+            "  --expect HASH     Exit with status 1 if the final hash differs\n"
+            "  --verbose         Keep the core's TRACK output (on stderr with `--export -` or `--terminal`)\n"
+            "  --export PATH     Stream every changed frame to PATH (`-` for stdout)\n"
+            "  --export-format F `y4m` (default) or `rgb`\n"
+            "  --export-scale N  Output pixels per emulated pixel (default 8)\n"
+            "  --export-lossless Wait for the encoder instead of dropping frames\n"
+            "  --profile         Print the guest profile (needs a CHIP8PP_PROFILE build)\n"
+            "  --no-fusion       Execute every instruction on its own (no fused sequences nor recompiled code)\n"
+            "  --plugin FILE     Load ROMs recompiled by chip8pp-aot from a shared library\n"
+            "  --terminal        Draw the display on the terminal, paced at 60 frames per second\n"
+            "  --metrics ADDR    Serve Prometheus metrics on tcp:HOST:PORT or unix:PATH during the run\n"
+            "  --timeline FILE   Record a trace-event timeline (chrome://tracing, Perfetto) into FILE\n",
+            program);
+    }
+
+    std::FILE *hashOutput = stdout;
+
+    void print_hash(uint64_t cycle, uint64_t frame, uint64_t hash) {
+        std::fprintf(hashOutput, "%llu %llu %016llx\n", (unsigned long long)cycle, (unsigned long long)frame, (unsigned long long)hash);
+    }
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::string        romPath     = argv[1];
+    uint64_t           cycles      = 10000;
+    uint64_t           frameCycles = 11;
+    bool               everyFrame  = false;
+    bool               verbose     = false;
+    bool               hasExpected = false;
+    uint64_t           expected    = 0;
+    std::set<uint64_t> checkpoints;
+    std::string        exportPath;
+    unsigned int       exportScale = 8;
+    bool               lossless    = false;
+    bool               terminal    = false;
+    std::string        corpusPath;
+    bool               profile     = false;
+    bool               fusion      = true;
+    std::string        metricsAddress;
+    std::string        timelinePath;
+
+    FrameExporter::Format    exportFormat = FrameExporter::Format::Y4M;
+    std::vector<std::string> plugins;
+
+    for (int argId = 2; argId < argc; ++argId) {
+        std::string arg = argv[argId];
+        bool hasValue = argId+1 < argc;
+
+        if (arg == "--cycles" && hasValue) {
+            cycles = std::strtoull(argv[++argId], NULL, 10);
+        } else if (arg == "--frame-cycles" && hasValue) {
+            frameCycles = std::strtoull(argv[++argId], NULL, 10);
+        } else if (arg == "--every-frame") {
+            everyFrame = true;
+        } else if (arg == "--at" && hasValue) {
+            std::stringstream list(argv[++argId]);
+            std::string checkpoint;
+            while (std::getline(list, checkpoint, ',')) {
+                checkpoints.insert(std::strtoull(checkpoint.c_str(), NULL, 10));
+            }
+        } else if (arg == "--expect" && hasValue) {
+            hasExpected = true;
+            expected    = std::strtoull(argv[++argId], NULL, 16);
+        } else if (arg == "--verbose") {
+            verbose = true;
+        } else if (arg == "--export" && hasValue) {
+            exportPath = argv[++argId];
+        } else if (arg == "--export-format" && hasValue) {
+            std::string format = argv[++argId];
+            if (format == "rgb") {
+                exportFormat = FrameExporter::Format::RGB;
+            } else if (format != "y4m") {
+                print_usage(argv[0]);
+                return 2;
+            }
+        } else if (arg == "--export-scale" && hasValue) {
+            exportScale = static_cast<unsigned int>(std::strtoul(argv[++argId], NULL, 10));
+        } else if (arg == "--export-lossless") {
+            lossless = true;
+        } else if (arg == "--corpus" && hasValue) {
+            corpusPath = argv[++argId];
+        } else if (arg == "--profile") {
+            profile = true;
+        } else if (arg == "--no-fusion") {
+            fusion = false;
+        } else if (arg == "--plugin" && hasValue) {
+            plugins.push_back(argv[++argId]);
+        } else if (arg == "--terminal") {
+            terminal = true;
+        } else if (arg == "--metrics" && hasValue) {
+            metricsAddress = argv[++argId];
+        } else if (arg == "--timeline" && hasValue) {
+            timelinePath = argv[++argId];
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (frameCycles == 0) {
+        frameCycles = 1;
+    }
+
+    std::streambuf *trackBuffer = std::cout.rdbuf();
+    if (!verbose) {
+        std::cout.rdbuf(NULL); // Silences the per-instruction TRACK logging
+    } else if (exportPath == "-" || terminal) {
+        std::cout.rdbuf(std::cerr.rdbuf()); // stdout carries the video stream or the screen
+    }
+
+    Chip8 emulator("Headless", true);
+    uint64_t cycle = 0;
+
+    if (!fusion) {
+        emulator.set_fusion_enabled(false);
+    }
+
+    FrameExporter    *exporter = NULL;
+    TerminalRenderer *screen   = NULL;
+
+    std::unique_ptr<MetricsServer>  metricsServer;
+    std::unique_ptr<TimelineWriter> timeline;
+
+    std::chrono::steady_clock::time_point nextFrame = std::chrono::steady_clock::now();
+
+    try {
+        if (!metricsAddress.empty()) {
+            metricsServer.reset(new MetricsServer(metricsAddress));
+        }
+        if (!timelinePath.empty()) {
+            timeline.reset(new TimelineWriter(timelinePath));
+            Timeline::name_thread("headless");
+        }
+
+        for (size_t pluginId = 0; pluginId < plugins.size(); ++pluginId) {
+            RecompiledRomRegistry::instance().load_plugin(plugins[pluginId]);
+        }
+
+        if (corpusPath.empty()) {
+            emulator.load_program(romPath);
+        } else {
+            RomCorpus corpus(corpusPath);
+            CorpusRom rom;
+
+            if (!corpus.find_any(romPath, rom)) {
+                throw std::runtime_error("ROM not found in corpus : `" + romPath + "`");
+            }
+
+            emulator.load_program(rom.bytes, rom.entry->size);
+        }
+
+        if (!exportPath.empty()) {
+            if (exportPath == "-") {
+                hashOutput = stderr; // Keep stdout clean for the video stream
+            }
+            exporter = new FrameExporter(exportPath, exportFormat, exportScale, 60);
+            exporter->submit(emulator.get_display_view(), emulator.get_frame_hash());
+        }
+
+        if (terminal) {
+            hashOutput = stderr;
+            screen     = new TerminalRenderer();
+        }
+
+        while (cycle < cycles) {
+            // Runs up to the next cycle something has to happen at : end of frame, checkpoint or end of run
+            uint64_t stop = std::min(cycles, (cycle / frameCycles + 1) * frameCycles);
+
+            std::set<uint64_t>::const_iterator checkpoint = checkpoints.upper_bound(cycle);
+            if (checkpoint != checkpoints.end() && *checkpoint < stop) {
+                stop = *checkpoint;
+            }
+
+            uint64_t batchStart = Timeline::enabled() ? Timeline::now() : 0;
+            emulator.run_cycles(stop - cycle);
+            Timeline::complete("emulate", "host", batchStart, batchStart != 0 ? Timeline::now() : 0, "cycles", stop - cycle);
+            cycle = stop;
+
+            bool endOfFrame = cycle % frameCycles == 0;
+            if (endOfFrame) {
+                emulator.tick_timers(); // Frames are cut here rather than by `run_frames()`
+                Metrics::add(Metrics::local().emulatedFrames, 1);
+                Timeline::instant("frame", "host", "frame", cycle / frameCycles);
+            }
+
+            if ((everyFrame && endOfFrame) || checkpoints.count(cycle)) {
+                print_hash(cycle, cycle / frameCycles, emulator.get_frame_hash());
+            }
+
+            if (exporter != NULL && endOfFrame) {
+                TimelineScope timelineScope("export", "host");
+                if (lossless) {
+                    exporter->wait_for_slot();
+                }
+                exporter->submit(emulator.get_display_view(), emulator.get_frame_hash());
+            }
+
+            if (screen != NULL && endOfFrame) {
+                {
+                    TimelineScope timelineScope("terminal", "host");
+                    screen->render(emulator.get_display_view());
+                }
+
+                nextFrame += std::chrono::microseconds(1000000 / 60);
+                std::this_thread::sleep_until(nextFrame);
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cout.rdbuf(trackBuffer);
+        std::fprintf(stderr, "Emulation stopped at cycle %llu : %s\n", (unsigned long long)emulator.get_instruction_count(), e.what());
+        delete exporter;
+        delete screen;
+        return 2;
+    }
+
+    std::cout.rdbuf(trackBuffer);
+
+    delete screen;
+
+    if (exporter != NULL) {
+        exporter->finish();
+        std::fprintf(stderr, "Exported %llu frames (%llu identical skipped, %llu dropped)\n",
+                     (unsigned long long)exporter->get_written_frames(),
+                     (unsigned long long)exporter->get_duplicate_frames(),
+                     (unsigned long long)exporter->get_overflow_frames());
+        delete exporter;
+    }
+
+    if (profile) {
+        emulator.print_profile_report(std::cerr);
+    }
+
+    uint64_t finalHash = emulator.get_frame_hash();
+    print_hash(cycle, cycle / frameCycles, finalHash);
+
+    if (hasExpected && finalHash != expected) {
+        std::fprintf(stderr, "Hash mismatch : expected %016llx\n", (unsigned long long)expected);
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,11 +1,60 @@
 #include "Chip8.hpp"
+#include "MetricsServer.hpp"
+#include "RomCorpus.hpp"
+#include "Timeline.hpp"
 
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+// Usage: chip8pp [options] [rom.ch8] | chip8pp [options] <corpus.c8pack> <title or hash>
+//   --swap-interval N  Screen refreshes per buffer swap, 0 disables vsync (default 1)
+//   --refresh HZ       Emulated frames per second (default 60)
+//   --frame-cycles N   Instructions per emulated frame (default 11)
+//   --metrics ADDR     Serve Prometheus metrics on tcp:HOST:PORT or unix:PATH
+//   --timeline FILE    Record a trace-event timeline (chrome://tracing, Perfetto) into FILE
 int main(int argc, char const *argv[]) {
     init_emu();
 
     Chip8 emulator("EmuTest");
 
-    emulator.load_program("resources/chipPrograms/Particle Demo [zeroZshadow, 2008].ch8");
+    std::unique_ptr<MetricsServer>  metricsServer;
+    std::unique_ptr<TimelineWriter> timeline;
+    std::vector<std::string>        positional;
+    for (int argId = 1; argId < argc; ++argId) {
+        std::string arg = argv[argId];
+        bool hasValue = argId+1 < argc;
+
+        if (arg == "--swap-interval" && hasValue) {
+            emulator.set_swap_interval(std::atoi(argv[++argId]));
+        } else if (arg == "--refresh" && hasValue) {
+            emulator.set_refresh_rate(std::strtod(argv[++argId], NULL));
+        } else if (arg == "--frame-cycles" && hasValue) {
+            emulator.set_frame_cycles(static_cast<unsigned int>(std::strtoul(argv[++argId], NULL, 10)));
+        } else if (arg == "--metrics" && hasValue) {
+            metricsServer.reset(new MetricsServer(argv[++argId]));
+        } else if (arg == "--timeline" && hasValue) {
+            timeline.reset(new TimelineWriter(argv[++argId]));
+            Timeline::name_thread("main");
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.size() >= 2) {
+        RomCorpus corpus(positional[0]);
+        CorpusRom rom;
+
+        if (!corpus.find_any(positional[1], rom)) {
+            throw std::runtime_error("ROM not found in corpus : `" + positional[1] + "`");
+        }
+
+        emulator.load_program(rom.bytes, rom.entry->size);
+    } else if (positional.size() == 1) {
+        emulator.load_program(positional[0]);
+    } else {
+        emulator.load_program("resources/chipPrograms/Particle Demo [zeroZshadow, 2008].ch8");
+    }
 
     emulator.run();
 
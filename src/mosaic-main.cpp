@@ -0,0 +1,137 @@
+#include "Chip8.hpp"
+#include "MosaicRenderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Mosaic frontend : runs many headless cores and shows all their displays in one window.
+//
+// ROMs are assigned to the instances in turn. The window title shows the frame rate and how many
+// displays had to be uploaded per frame.
+
+namespace {
+    void print_usage(const char *program) {
+        std::fprintf(stderr,
+            "Usage: %s <rom> [rom...] [options]\n"
+            "  --instances N     Number of cores (default 16)\n"
+            "  --columns N       Tiles per row (default: square-ish grid)\n"
+            "  --frame-cycles N  Instructions per core and per frame (default 11)\n",
+            program);
+    }
+
+    void glfw_frame_size_callback(GLFWwindow *, int width, int height) {
+        glViewport(0, 0, width, height);
+    }
+}
+
+int main(int argc, char const *argv[]) {
+    std::vector<std::string> roms;
+    size_t                   instanceCount = 16;
+    unsigned int             columns       = 0;
+    uint64_t                 frameCycles   = 11;
+
+    for (int argId = 1; argId < argc; ++argId) {
+        std::string arg = argv[argId];
+        bool hasValue = argId+1 < argc;
+
+        if (arg == "--instances" && hasValue) {
+            instanceCount = std::strtoull(argv[++argId], NULL, 10);
+        } else if (arg == "--columns" && hasValue) {
+            columns = static_cast<unsigned int>(std::strtoul(argv[++argId], NULL, 10));
+        } else if (arg == "--frame-cycles" && hasValue) {
+            frameCycles = std::strtoull(argv[++argId], NULL, 10);
+        } else if (arg.compare(0, 2, "--") == 0) {
+            print_usage(argv[0]);
+            return 2;
+        } else {
+            roms.push_back(arg);
+        }
+    }
+
+    if (roms.empty() || instanceCount == 0) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::cout.rdbuf(NULL); // The cores' TRACK output would cost more than the emulation itself
+
+    std::vector<std::unique_ptr<Chip8>> cores;
+    std::vector<bool>                   halted(instanceCount, false);
+    std::vector<DisplayView>            views(instanceCount);
+
+    for (size_t instance = 0; instance < instanceCount; ++instance) {
+        cores.emplace_back(new Chip8("Mosaic" + std::to_string(instance), true));
+        cores.back()->set_frame_cycles(static_cast<unsigned int>(frameCycles));
+        cores.back()->load_program(roms[instance % roms.size()]); // The ROM cache reads every file once
+    }
+
+    init_emu();
+
+    unsigned int tileColumns = columns > 0 ? columns : static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<double>(instanceCount))));
+    unsigned int tileRows    = static_cast<unsigned int>((instanceCount + tileColumns - 1) / tileColumns);
+    int          width       = 1280;
+    int          height      = std::max(160, static_cast<int>(width * tileRows / (2 * tileColumns)));
+
+    GLFWwindow *window = glfwCreateWindow(width, height, "chip8pp mosaic", NULL, NULL);
+    if (window == NULL) {
+        throw std::runtime_error("GLFW error : Failed to create the mosaic window");
+    }
+
+    glfwMakeContextCurrent(window);
+    gladLoadGL(glfwGetProcAddress);
+    glfwSetFramebufferSizeCallback(window, glfw_frame_size_callback);
+    glfwSwapInterval(1);
+
+    {
+        MosaicRenderer mosaic(instanceCount, columns);
+
+        double   statisticsStart = glfwGetTime();
+        uint64_t frames          = 0;
+        uint64_t uploads         = 0;
+
+        while (!glfwWindowShouldClose(window)) {
+            for (size_t instance = 0; instance < instanceCount; ++instance) {
+                if (!halted[instance]) {
+                    try {
+                        cores[instance]->run_frames(1); // Ticks the timers, like the window
+                    } catch (const std::exception &error) {
+                        std::cerr << "Instance " << instance << " halted : " << error.what() << "\n";
+                        halted[instance] = true; // Its last display stays on screen
+                    }
+                }
+
+                views[instance] = cores[instance]->get_display_view();
+            }
+
+            mosaic.draw(views.data());
+            uploads += mosaic.get_last_upload_count();
+            ++frames;
+
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+
+            double elapsed = glfwGetTime() - statisticsStart;
+            if (elapsed >= 1.0) {
+                char title[128];
+                std::snprintf(title, sizeof(title), "chip8pp mosaic - %zu instances, %.1f fps, %.1f uploads/frame",
+                              instanceCount, frames / elapsed, static_cast<double>(uploads) / frames);
+                glfwSetWindowTitle(window, title);
+
+                statisticsStart += elapsed;
+                frames = uploads = 0;
+            }
+        }
+    }
+
+    glfwDestroyWindow(window);
+    terminate_emu();
+
+    return 0;
+}
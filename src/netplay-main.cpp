@@ -0,0 +1,211 @@
+#include "Chip8.hpp"
+#include "DatagramSocket.hpp"
+#include "RollbackSession.hpp"
+#include "TerminalRenderer.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+
+// Two-player netplay over local sockets with rollback. Run one process per player, e.g.
+//
+//   chip8pp-netplay pong.ch8 --player 1 --local unix:/tmp/p1 --remote unix:/tmp/p2
+//   chip8pp-netplay pong.ch8 --player 2 --local unix:/tmp/p2 --remote unix:/tmp/p1
+//
+// Player 1 holds keys 1 and 4, player 2 keys C and D (the usual Pong layout), driven by a random
+// script so that runs are reproducible. Once both sides confirmed every input, each prints the state
+// hash of the last frame; the two must match. The exit status is 1 on a desync or hash mismatch.
+
+namespace {
+    const uint8_t PLAYER_KEYS[2][2] = {{0x1, 0x4}, {0xC, 0xD}};
+
+    const unsigned int LINGER_FRAMES   = 30;   ///< Frames spent answering the peer after the run
+    const int          PEER_TIMEOUT_MS = 5000; ///< Silence after which the peer is given up on
+
+    void print_usage(const char *program) {
+        std::fprintf(stderr,
+            "Usage: %s <rom> --player 1|2 --local ADDR --remote ADDR [options]\n"
+            "  ADDR               udp:HOST:PORT or unix:PATH\n"
+            "  --frames N         Frames to play (default 600)\n"
+            "  --max-rollback N   Frames run ahead of the remote input, at most (default 8, up to 60)\n"
+            "  --seed N           Random seed of the core, the same on both sides (default 0)\n"
+            "  --input-seed N     Seed of the scripted input (default 1)\n"
+            "  --frame-cycles N   Instructions per emulated frame (default 11)\n"
+            "  --unpaced          Run as fast as the peer allows instead of 60 frames per second\n"
+            "  --terminal         Draw the display on the terminal\n"
+            "  --expect HASH      Exit with status 1 if the final state hash differs\n",
+            program);
+    }
+
+    /// Keys of `player`, held for random stretches of 5 to 30 frames
+    class ScriptedInput {
+        private: // Private fields
+            std::mt19937 engine;    ///< Script generator
+            unsigned int player;    ///< 0 or 1
+            unsigned int remaining; ///< Frames left with `keys` held
+            uint16_t     keys;      ///< Keys held now
+
+        public:  // Public functions
+            ScriptedInput(uint32_t seed, unsigned int player) : engine(seed * 2 + player), player(player), remaining(0), keys(0) {}
+
+            uint16_t next() {
+                if (this->remaining == 0) {
+                    unsigned int choice = this->engine() % 3;
+                    this->keys      = choice == 2 ? 0 : static_cast<uint16_t>(1 << PLAYER_KEYS[this->player][choice]);
+                    this->remaining = 5 + this->engine() % 26;
+                }
+                --this->remaining;
+                return this->keys;
+            }
+    };
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::string  romPath     = argv[1];
+    unsigned int player      = 0;
+    std::string  localAddress;
+    std::string  remoteAddress;
+    int64_t      frames      = 600;
+    unsigned int maxRollback = 8;
+    uint32_t     seed        = 0;
+    uint32_t     inputSeed   = 1;
+    unsigned int frameCycles = 11;
+    bool         paced       = true;
+    bool         terminal    = false;
+    bool         hasExpected = false;
+    uint64_t     expected    = 0;
+
+    for (int argId = 2; argId < argc; ++argId) {
+        std::string arg = argv[argId];
+        bool hasValue = argId+1 < argc;
+
+        if (arg == "--player" && hasValue) {
+            player = static_cast<unsigned int>(std::strtoul(argv[++argId], NULL, 10));
+        } else if (arg == "--local" && hasValue) {
+            localAddress = argv[++argId];
+        } else if (arg == "--remote" && hasValue) {
+            remoteAddress = argv[++argId];
+        } else if (arg == "--frames" && hasValue) {
+            frames = std::strtoll(argv[++argId], NULL, 10);
+        } else if (arg == "--max-rollback" && hasValue) {
+            maxRollback = static_cast<unsigned int>(std::strtoul(argv[++argId], NULL, 10));
+        } else if (arg == "--seed" && hasValue) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[++argId], NULL, 10));
+        } else if (arg == "--input-seed" && hasValue) {
+            inputSeed = static_cast<uint32_t>(std::strtoul(argv[++argId], NULL, 10));
+        } else if (arg == "--frame-cycles" && hasValue) {
+            frameCycles = static_cast<unsigned int>(std::strtoul(argv[++argId], NULL, 10));
+        } else if (arg == "--unpaced") {
+            paced = false;
+        } else if (arg == "--terminal") {
+            terminal = true;
+        } else if (arg == "--expect" && hasValue) {
+            hasExpected = true;
+            expected    = std::strtoull(argv[++argId], NULL, 16);
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if ((player != 1 && player != 2) || localAddress.empty() || remoteAddress.empty() || frames <= 0) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::cout.rdbuf(NULL); // Silences the per-instruction TRACK logging
+
+    try {
+        Chip8 initial("Netplay", true);
+        initial.load_program(romPath);
+        initial.set_frame_cycles(frameCycles);
+        initial.set_random_seed(seed);
+
+        RollbackSession                   session(initial, maxRollback);
+        DatagramSocket                    socket(localAddress, remoteAddress);
+        ScriptedInput                     script(inputSeed, player - 1);
+        std::unique_ptr<TerminalRenderer> screen(terminal ? new TerminalRenderer() : NULL);
+
+        uint8_t      packet[RollbackSession::MAX_PACKET_SIZE];
+        uint16_t     input        = script.next();
+        unsigned int linger       = 0;
+        uint64_t     stalledTicks = 0;
+
+        std::chrono::steady_clock::time_point lastHeard = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point nextFrame = lastHeard;
+
+        while (linger < LINGER_FRAMES) {
+            for (long size = socket.receive(packet, sizeof(packet)); size >= 0; size = socket.receive(packet, sizeof(packet))) {
+                if (session.read_packet(packet, static_cast<size_t>(size))) {
+                    lastHeard = std::chrono::steady_clock::now();
+                }
+            }
+
+            bool stalled = false;
+            if (session.get_frame() < frames) {
+                if (session.advance(input)) {
+                    input = script.next();
+                    if (screen != NULL) {
+                        screen->render(session.get_core().get_display_view());
+                    }
+                } else {
+                    stalled = true;
+                    ++stalledTicks;
+                }
+            }
+
+            socket.send(packet, session.write_packet(packet));
+
+            bool finished = session.get_hashed_frame() >= frames && session.get_acknowledged_frame() >= frames - 1
+                            && session.get_remote_hash_frame() >= frames;
+            if (finished || session.get_desync_frame() >= 0) {
+                ++linger; // Keeps answering for a while, in case our last packets got lost
+            }
+
+            if (std::chrono::steady_clock::now() - lastHeard > std::chrono::milliseconds(PEER_TIMEOUT_MS)) {
+                throw std::runtime_error("Netplay error : no news from the peer for " + std::to_string(PEER_TIMEOUT_MS) + " ms");
+            }
+
+            if (paced) {
+                nextFrame += std::chrono::microseconds(1000000 / 60);
+                std::this_thread::sleep_until(nextFrame);
+            } else if (stalled || session.get_frame() >= frames) {
+                socket.wait(1);
+            }
+        }
+
+        screen.reset();
+
+        std::fprintf(stderr, "Player %u : %lld frames, %llu rollbacks, %llu frames simulated again, %llu stalled ticks\n", player,
+                     (long long)session.get_frame(), (unsigned long long)session.get_rollbacks(),
+                     (unsigned long long)session.get_resimulated_frames(), (unsigned long long)stalledTicks);
+
+        if (session.get_desync_frame() >= 0) {
+            std::fprintf(stderr, "Desync : the peer's state differs at frame %lld\n", (long long)session.get_desync_frame());
+            return 1;
+        }
+
+        uint64_t finalHash = session.get_hash(frames);
+        std::printf("%lld %016llx\n", (long long)frames, (unsigned long long)finalHash);
+
+        if (hasExpected && finalHash != expected) {
+            std::fprintf(stderr, "Hash mismatch : expected %016llx\n", (unsigned long long)expected);
+            return 1;
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 2;
+    }
+
+    return 0;
+}
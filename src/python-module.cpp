@@ -0,0 +1,85 @@
+#include "VecEnv.hpp"
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <stdexcept>
+#include <vector>
+
+// Python bindings of `VecEnv` (module `chip8pp`).
+//
+// Observations, rewards and dones live in NumPy arrays allocated once per environment batch; C++
+// writes straight into them and `reset()` / `step()` return those same arrays, so nothing is copied.
+// The returned arrays are overwritten by the next call : copy them to keep a history.
+
+namespace py = pybind11;
+
+namespace {
+    class PyVecEnv {
+        private: // Private fields
+            VecEnv               env;           ///< Environments
+            py::array_t<uint8_t> observations;  ///< N x 32 x 64 pixels
+            py::array_t<float>   rewards;       ///< N rewards of the last step
+            py::array_t<bool>    dones;         ///< N episode ends of the last step
+            unsigned int         framesPerStep; ///< Frames per call to `step()`
+
+        public:  // Public functions
+            PyVecEnv(const std::string &romPath, size_t envCount, unsigned int framesPerStep, unsigned int threadCount)
+                    : env(romPath, envCount, threadCount),
+                      observations(std::vector<py::ssize_t>{static_cast<py::ssize_t>(envCount), DisplayView::HEIGHT, DisplayView::WIDTH}),
+                      rewards(static_cast<py::ssize_t>(envCount)), dones(static_cast<py::ssize_t>(envCount)),
+                      framesPerStep(framesPerStep) {}
+
+            py::array_t<uint8_t> reset(py::array_t<uint32_t, py::array::c_style | py::array::forcecast> seeds) {
+                if (static_cast<size_t>(seeds.size()) != this->env.size()) {
+                    throw std::invalid_argument("reset() needs one seed per environment");
+                }
+
+                const uint32_t *seedData        = seeds.data();
+                uint8_t        *observationData = this->observations.mutable_data();
+                {
+                    py::gil_scoped_release release;
+                    this->env.reset(seedData, observationData);
+                }
+                return this->observations;
+            }
+
+            py::tuple step(py::array_t<uint8_t, py::array::c_style | py::array::forcecast> actions) {
+                if (static_cast<size_t>(actions.size()) != this->env.size()) {
+                    throw std::invalid_argument("step() needs one action per environment");
+                }
+
+                const uint8_t *actionData      = actions.data();
+                uint8_t       *observationData = this->observations.mutable_data();
+                float         *rewardData      = this->rewards.mutable_data();
+                uint8_t       *doneData        = reinterpret_cast<uint8_t *>(this->dones.mutable_data()); // NumPy bools are bytes
+                {
+                    py::gil_scoped_release release;
+                    this->env.step(actionData, this->framesPerStep, observationData, rewardData, doneData);
+                }
+                return py::make_tuple(this->observations, this->rewards, this->dones);
+            }
+
+            VecEnv &get_env() {
+                return this->env;
+            }
+    };
+}
+
+PYBIND11_MODULE(chip8pp, module) {
+    module.doc() = "Vectorized CHIP-8 environments";
+
+    py::class_<PyVecEnv>(module, "VecEnv")
+        .def(py::init<const std::string &, size_t, unsigned int, unsigned int>(),
+             py::arg("rom"), py::arg("num_envs"), py::arg("frames_per_step") = 4, py::arg("threads") = 0)
+        .def("reset", &PyVecEnv::reset, py::arg("seeds"),
+             "Starts a new episode everywhere and returns the observations (num_envs x 32 x 64 uint8)")
+        .def("step", &PyVecEnv::step, py::arg("actions"),
+             "Holds key `actions[i]` (0-15, 255 for none) and returns (observations, rewards, dones)")
+        .def("set_frame_cycles", [](PyVecEnv &self, unsigned int frameCycles) { self.get_env().set_frame_cycles(frameCycles); })
+        .def("set_max_episode_frames", [](PyVecEnv &self, uint64_t frames) { self.get_env().set_max_episode_frames(frames); })
+        .def("set_score_address", [](PyVecEnv &self, int address) { self.get_env().set_score_address(address); })
+        .def_property_readonly("num_envs", [](PyVecEnv &self) { return self.get_env().size(); })
+        .def_property_readonly("threads", [](PyVecEnv &self) { return self.get_env().get_thread_count(); });
+}